@@ -0,0 +1,231 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#include "ImGuiFontAtlasCache.h"
+#include "Engine/Platform/Platform.h"
+#include "ImGui/imgui.h"
+#include "ImGui/imgui_internal.h"
+
+#define IMGUI_FONT_ATLAS_MAGIC 0x41464d49 // 'IMFA'
+#define IMGUI_FONT_ATLAS_VERSION 2
+
+namespace
+{
+    template<typename T>
+    void Write(Array<byte>& output, const T& value)
+    {
+        output.Add((const byte*)&value, sizeof(T));
+    }
+
+    template<typename T>
+    void WriteArray(Array<byte>& output, const ImVector<T>& value)
+    {
+        Write(output, value.Size);
+        output.Add((const byte*)value.Data, value.size_in_bytes());
+    }
+
+    struct Reader
+    {
+        const byte* Ptr;
+        const byte* End;
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            if (Ptr + sizeof(T) > End)
+                return true;
+            Platform::MemoryCopy(&value, Ptr, sizeof(T));
+            Ptr += sizeof(T);
+            return false;
+        }
+
+        template<typename T>
+        bool ReadArray(ImVector<T>& value)
+        {
+            int32 count;
+            if (Read(count) || count < 0 || Ptr + count * sizeof(T) > End)
+                return true;
+            value.resize(count);
+            Platform::MemoryCopy(value.Data, Ptr, count * sizeof(T));
+            Ptr += count * sizeof(T);
+            return false;
+        }
+    };
+
+    int32 GetFontIndex(const ImFontAtlas* atlas, const ImFont* font)
+    {
+        return font ? atlas->Fonts.index_from_ptr(atlas->Fonts.find(const_cast<ImFont*>(font))) : -1;
+    }
+}
+
+uint32 ImGuiFontAtlasCache::GetConfigHash(const ImFontAtlas* atlas)
+{
+    const int32 version = IMGUI_FONT_ATLAS_VERSION;
+    ImU32 hash = ImHashData(&version, sizeof(version), IMGUI_VERSION_NUM);
+#define HASH(value) hash = ImHashData(&(value), sizeof(value), hash)
+    HASH(atlas->Flags);
+    HASH(atlas->TexDesiredWidth);
+    HASH(atlas->TexGlyphPadding);
+    HASH(atlas->TexSdfPadding);
+    HASH(atlas->FontBuilderFlags);
+    for (const ImFontConfig& config : atlas->ConfigData)
+    {
+        hash = ImHashData(config.FontData, config.FontDataSize, hash);
+        HASH(config.FontNo);
+        HASH(config.SizePixels);
+        HASH(config.OversampleH);
+        HASH(config.OversampleV);
+        HASH(config.PixelSnapH);
+        HASH(config.GlyphExtraSpacing);
+        HASH(config.GlyphOffset);
+        HASH(config.GlyphMinAdvanceX);
+        HASH(config.GlyphMaxAdvanceX);
+        HASH(config.MergeMode);
+        HASH(config.FontBuilderFlags);
+        HASH(config.RasterizerMultiply);
+        HASH(config.EllipsisChar);
+        const ImWchar* ranges = config.GlyphRanges ? config.GlyphRanges : const_cast<ImFontAtlas*>(atlas)->GetGlyphRangesDefault();
+        for (; *ranges; ranges++)
+            HASH(*ranges);
+    }
+    for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    {
+        // Skip built-in rectangles (added during build)
+        const int32 index = atlas->CustomRects.index_from_ptr(&rect);
+        if (index == atlas->PackIdMouseCursors || index == atlas->PackIdLines)
+            continue;
+        HASH(rect.Width);
+        HASH(rect.Height);
+        HASH(rect.GlyphID);
+        HASH(rect.GlyphAdvanceX);
+        HASH(rect.GlyphOffset);
+        const int32 fontIndex = GetFontIndex(atlas, rect.Font);
+        HASH(fontIndex);
+    }
+#undef HASH
+    return hash;
+}
+
+bool ImGuiFontAtlasCache::Save(const ImFontAtlas* atlas, Array<byte>& output)
+{
+    if (!atlas->IsBuilt() || !atlas->TexPixelsAlpha8 || atlas->TexPixelsUseColors)
+        return true;
+    output.Clear();
+
+    // Header
+    Write(output, (uint32)IMGUI_FONT_ATLAS_MAGIC);
+    Write(output, (int32)IMGUI_FONT_ATLAS_VERSION);
+    Write(output, GetConfigHash(atlas));
+
+    // Atlas
+    Write(output, atlas->TexWidth);
+    Write(output, atlas->TexHeight);
+    Write(output, atlas->TexOccupancy);
+    Write(output, atlas->TexUvScale);
+    Write(output, atlas->TexUvWhitePixel);
+    Write(output, atlas->TexUvLines);
+    Write(output, atlas->PackIdMouseCursors);
+    Write(output, atlas->PackIdLines);
+    Write(output, atlas->CustomRects.Size);
+    for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    {
+        ImFontAtlasCustomRect data = rect;
+        data.Font = nullptr;
+        Write(output, data);
+        Write(output, GetFontIndex(atlas, rect.Font));
+    }
+    output.Add(atlas->TexPixelsAlpha8, atlas->TexWidth * atlas->TexHeight);
+
+    // Fonts
+    Write(output, atlas->Fonts.Size);
+    for (const ImFont* font : atlas->Fonts)
+    {
+        Write(output, (int32)(font->ConfigData - atlas->ConfigData.Data));
+        Write(output, font->ConfigDataCount);
+        Write(output, font->FontSize);
+        Write(output, font->Ascent);
+        Write(output, font->Descent);
+        Write(output, font->MetricsTotalSurface);
+        Write(output, font->FallbackChar);
+        Write(output, font->EllipsisChar);
+        WriteArray(output, font->Glyphs);
+    }
+    return false;
+}
+
+bool ImGuiFontAtlasCache::Load(ImFontAtlas* atlas, const Span<byte>& data)
+{
+    Reader reader = { data.Get(), data.Get() + data.Length() };
+    uint32 magic, hash;
+    int32 version;
+    if (reader.Read(magic) || reader.Read(version) || reader.Read(hash) ||
+        magic != IMGUI_FONT_ATLAS_MAGIC || version != IMGUI_FONT_ATLAS_VERSION || hash != GetConfigHash(atlas))
+        return true;
+
+    // Atlas
+    int32 width, height, rectsCount;
+    float occupancy;
+    if (reader.Read(width) || reader.Read(height) || reader.Read(occupancy) || width <= 0 || height <= 0)
+        return true;
+    ImVec2 uvScale, uvWhitePixel;
+    ImVec4 uvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+    int32 packIdMouseCursors, packIdLines;
+    if (reader.Read(uvScale) || reader.Read(uvWhitePixel) || reader.Read(uvLines) || reader.Read(packIdMouseCursors) || reader.Read(packIdLines) || reader.Read(rectsCount) || rectsCount < 0)
+        return true;
+    ImVector<ImFontAtlasCustomRect> rects;
+    rects.resize(rectsCount);
+    for (ImFontAtlasCustomRect& rect : rects)
+    {
+        int32 fontIndex;
+        if (reader.Read(rect) || reader.Read(fontIndex) || fontIndex >= atlas->Fonts.Size)
+            return true;
+        rect.Font = fontIndex >= 0 ? atlas->Fonts[fontIndex] : nullptr;
+    }
+    const byte* pixels = reader.Ptr;
+    reader.Ptr += width * height;
+    if (reader.Ptr > reader.End)
+        return true;
+
+    // Fonts
+    int32 fontsCount;
+    if (reader.Read(fontsCount) || fontsCount != atlas->Fonts.Size)
+        return true;
+    for (ImFont* font : atlas->Fonts)
+    {
+        int32 configIndex;
+        if (reader.Read(configIndex) || configIndex < 0 || configIndex >= atlas->ConfigData.Size ||
+            reader.Read(font->ConfigDataCount) ||
+            reader.Read(font->FontSize) ||
+            reader.Read(font->Ascent) ||
+            reader.Read(font->Descent) ||
+            reader.Read(font->MetricsTotalSurface) ||
+            reader.Read(font->FallbackChar) ||
+            reader.Read(font->EllipsisChar) ||
+            reader.ReadArray(font->Glyphs))
+        {
+            atlas->ClearTexData();
+            for (ImFont* e : atlas->Fonts)
+                e->ClearOutputData();
+            return true;
+        }
+        font->ConfigData = &atlas->ConfigData[configIndex];
+        font->ContainerAtlas = atlas;
+        font->BuildLookupTable();
+    }
+
+    // Setup atlas texture (as after build)
+    atlas->ClearTexData();
+    atlas->TexWidth = width;
+    atlas->TexHeight = height;
+    atlas->TexOccupancy = occupancy;
+    atlas->TexUvScale = uvScale;
+    atlas->TexUvWhitePixel = uvWhitePixel;
+    Platform::MemoryCopy(atlas->TexUvLines, uvLines, sizeof(uvLines));
+    atlas->CustomRects.swap(rects);
+    atlas->PackIdMouseCursors = packIdMouseCursors;
+    atlas->PackIdLines = packIdLines;
+    atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(width * height);
+    Platform::MemoryCopy(atlas->TexPixelsAlpha8, pixels, width * height);
+    atlas->TexPixelsUseColors = false;
+    atlas->TexReady = true;
+    return false;
+}
@@ -0,0 +1,39 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Core/Types/BaseTypes.h"
+#include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Collections/Array.h"
+
+struct ImFontAtlas;
+
+/// <summary>
+/// Serialization of the built ImGui font atlas (texture pixels and fonts glyph tables). Allows to bake the atlas into an asset and skip fonts rasterization at runtime.
+/// </summary>
+class ImGuiFontAtlasCache
+{
+public:
+    /// <summary>
+    /// Calculates the hash of the font atlas configuration (fonts data, sizes, glyph ranges and build settings). Used to validate the baked atlas.
+    /// </summary>
+    /// <param name="atlas">The font atlas (with fonts added).</param>
+    /// <returns>The configuration hash.</returns>
+    static uint32 GetConfigHash(const ImFontAtlas* atlas);
+
+    /// <summary>
+    /// Serializes the built font atlas.
+    /// </summary>
+    /// <param name="atlas">The built font atlas.</param>
+    /// <param name="output">The output data.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    static bool Save(const ImFontAtlas* atlas, Array<byte>& output);
+
+    /// <summary>
+    /// Deserializes the built font atlas. Fails if data was baked for the different fonts configuration.
+    /// </summary>
+    /// <param name="atlas">The font atlas (with the same fonts added as when it was saved).</param>
+    /// <param name="data">The serialized data.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    static bool Load(ImFontAtlas* atlas, const Span<byte>& data);
+};
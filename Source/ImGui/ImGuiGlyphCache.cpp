@@ -0,0 +1,476 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#include "ImGuiGlyphCache.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Profiler/Profiler.h"
+#include "Engine/Threading/Task.h"
+#include "ImGui/imgui_internal.h"
+
+// Private stb_truetype instance (memory allocations are thread-safe so glyphs can be rasterized on a background thread)
+#ifndef __STB_INCLUDE_STB_TRUETYPE_H__
+#define STBTT_malloc(x, u) ((void)(u), Platform::Allocate(x, 16))
+#define STBTT_free(x, u) ((void)(u), Platform::Free(x))
+#define STBTT_assert(x) do { IM_ASSERT(x); } while(0)
+#define STBTT_fmod(x, y) ImFmod(x, y)
+#define STBTT_sqrt(x) ImSqrt(x)
+#define STBTT_pow(x, y) ImPow(x, y)
+#define STBTT_fabs(x) ImFabs(x)
+#define STBTT_ifloor(x) ((int)ImFloorSigned(x))
+#define STBTT_iceil(x) ((int)ImCeil(x))
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#if defined(IMGUI_ENABLE_SSE)
+#define STBTT_SSE2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define STBTT_NEON
+#endif
+#include "ImGui/imstb_truetype.h"
+#endif
+
+// The minimum amount of updates since the last use of the glyph to evict it (draw data of the previous frames can still use it)
+#define IMGUI_DYNAMIC_GLYPHS_MIN_AGE 4
+
+namespace
+{
+    bool InitFontInfo(stbtt_fontinfo& info, const ImFontConfig& config)
+    {
+        const unsigned char* data = (const unsigned char*)config.FontData;
+        return data && stbtt_InitFont(&info, data, stbtt_GetFontOffsetForIndex(data, config.FontNo)) != 0;
+    }
+
+    float GetFontScale(const stbtt_fontinfo& info, const ImFontConfig& config)
+    {
+        return config.SizePixels > 0 ? stbtt_ScaleForPixelHeight(&info, config.SizePixels) : stbtt_ScaleForMappingEmToPixels(&info, -config.SizePixels);
+    }
+}
+
+void ImGuiGlyphCache::Init(ImFontAtlas* atlas)
+{
+    if (IMGUI_DYNAMIC_GLYPHS <= 0)
+        return;
+
+    // Size the slots to fit the largest glyph of all fonts (the same way as the atlas builder does)
+    const bool sdf = (atlas->Flags & ImFontAtlasFlags_SignedDistanceField) != 0;
+    const int32 sdfPadding = sdf ? atlas->TexSdfPadding * 2 : 0;
+    int32 width = 0, height = 0;
+    for (const ImFontConfig& config : atlas->ConfigData)
+    {
+        stbtt_fontinfo info;
+        if (!InitFontInfo(info, config))
+            continue;
+        const float scale = GetFontScale(info, config);
+        const int32 oversampleH = sdf ? 1 : config.OversampleH, oversampleV = sdf ? 1 : config.OversampleV;
+        int x0, y0, x1, y1;
+        stbtt_GetFontBoundingBox(&info, &x0, &y0, &x1, &y1);
+        width = Math::Max(width, (int32)ImCeil((float)(x1 - x0) * scale * (float)oversampleH) + oversampleH + sdfPadding);
+        height = Math::Max(height, (int32)ImCeil((float)(y1 - y0) * scale * (float)oversampleV) + oversampleV + sdfPadding);
+    }
+    if (width <= 0 || height <= 0)
+        return;
+    _atlas = atlas;
+    _cellWidth = width + atlas->TexGlyphPadding;
+    _cellHeight = height + atlas->TexGlyphPadding;
+    _firstRect = atlas->CustomRects.Size;
+    for (int32 i = 0; i < IMGUI_DYNAMIC_GLYPHS; i++)
+        atlas->AddCustomRectRegular(_cellWidth, _cellHeight);
+}
+
+void ImGuiGlyphCache::Setup()
+{
+    if (!_atlas || !_atlas->IsBuilt() || _atlas->CustomRects.Size < _firstRect + IMGUI_DYNAMIC_GLYPHS)
+        return;
+    PROFILE_CPU();
+
+    // Slots
+    _slots.Resize(IMGUI_DYNAMIC_GLYPHS);
+    for (int32 i = 0; i < IMGUI_DYNAMIC_GLYPHS; i++)
+    {
+        const ImFontAtlasCustomRect& rect = _atlas->CustomRects[_firstRect + i];
+        Slot& slot = _slots[i];
+        slot.X = rect.X;
+        slot.Y = rect.Y;
+        slot.Font = nullptr;
+        slot.Glyph = -1;
+        slot.Upload = -1;
+    }
+
+    // Font sources
+    for (const ImFontConfig& config : _atlas->ConfigData)
+    {
+        stbtt_fontinfo info;
+        if (!config.DstFont || !InitFontInfo(info, config))
+            continue;
+        Source& source = _sources.AddOne();
+        source.Font = config.DstFont;
+        source.Config = &config;
+        source.Info = New<stbtt_fontinfo>(info);
+        source.Scale = GetFontScale(info, config);
+        source.Offset = ImVec2(config.GlyphOffset.x, config.GlyphOffset.y + IM_ROUND(config.DstFont->Ascent));
+        ImFontAtlasBuildMultiplyCalcLookupTable(source.Multiply, config.RasterizerMultiply);
+    }
+
+    // Fonts
+    for (ImFont* font : _atlas->Fonts)
+    {
+        if (font->Glyphs.Size + IMGUI_DYNAMIC_GLYPHS >= 0xFFFF)
+            continue;
+
+        // Reserve glyphs memory up-front so pointers to the font glyphs stay valid
+        const int32 fallbackGlyph = font->FallbackGlyph ? (int32)(font->FallbackGlyph - font->Glyphs.Data) : -1;
+        font->Glyphs.reserve(font->Glyphs.Size + IMGUI_DYNAMIC_GLYPHS);
+        if (fallbackGlyph != -1)
+            font->FallbackGlyph = &font->Glyphs.Data[fallbackGlyph];
+        font->DynamicGlyphsStart = font->Glyphs.Size;
+        font->DynamicGlyphsLastUse.reserve(IMGUI_DYNAMIC_GLYPHS);
+        FontData& data = _fonts.AddOne();
+        data.Font = font;
+    }
+
+    _atlas->GlyphMissingCallback = OnGlyphMissing;
+    _atlas->GlyphMissingUserData = this;
+}
+
+void ImGuiGlyphCache::Dispose()
+{
+    while (Platform::AtomicRead(&_working) != 0)
+        Platform::Sleep(1);
+    if (_atlas)
+    {
+        _atlas->GlyphMissingCallback = nullptr;
+        _atlas->GlyphMissingUserData = nullptr;
+        _atlas = nullptr;
+    }
+    for (Source& source : _sources)
+        Delete(source.Info);
+    _sources.Clear();
+    _fonts.Clear();
+    _slots.Clear();
+    _requests.Clear();
+    _batch.Clear();
+    _results.Clear();
+    _resultsPixels.Clear();
+    _uploads.Clear();
+    _uploadsPixels.Clear();
+    _uploadsRGBA.Clear();
+    SAFE_DELETE_GPU_RESOURCE(_uploadTexture);
+    GlyphsCount = 0;
+}
+
+void ImGuiGlyphCache::Update(int32 keepFrame)
+{
+    if (!_atlas || _slots.IsEmpty())
+        return;
+    _keepFrame = keepFrame;
+    _atlas->DynamicGlyphsFrame++;
+    if (Platform::AtomicRead(&_working) != 0)
+        return;
+
+    // Add glyphs rasterized in the background
+    if (_results.HasItems())
+    {
+        PROFILE_CPU_NAMED("AddGlyphs");
+        for (const Result& result : _results)
+            AddGlyph(result);
+        _results.Clear();
+        _resultsPixels.Clear();
+    }
+
+    // Rasterize glyphs requested in the last frame
+    if (_requests.HasItems())
+    {
+        _batch.Clear();
+        _batch.Swap(_requests);
+        Platform::AtomicStore(&_working, 1);
+        Function<void()> action;
+        action.Bind<ImGuiGlyphCache, &ImGuiGlyphCache::Rasterize>(this);
+        if (!Task::StartNew(action))
+            Rasterize();
+    }
+}
+
+bool ImGuiGlyphCache::IsSlotRect(int32 index) const
+{
+    return _firstRect != -1 && index >= _firstRect && index < _firstRect + IMGUI_DYNAMIC_GLYPHS;
+}
+
+void ImGuiGlyphCache::Flush(GPUContext* context, GPUTexture* texture)
+{
+    if (_uploads.IsEmpty())
+        return;
+    PROFILE_GPU_CPU("ImGui.Glyphs");
+
+    // Upload every slot into the small texture and copy it into the atlas (with the cell padding to clear the previous glyph)
+    const PixelFormat format = texture->Format();
+    if (!_uploadTexture || _uploadTexture->Format() != format)
+    {
+        SAFE_DELETE_GPU_RESOURCE(_uploadTexture);
+        _uploadTexture = GPUDevice::Instance->CreateTexture(TEXT("ImGui.GlyphUpload"));
+        if (_uploadTexture->Init(GPUTextureDescription::New2D(_cellWidth, _cellHeight, 1, format, GPUTextureFlags::ShaderResource)))
+        {
+            LOG(Error, "Failed to create ImGui glyphs upload texture.");
+            SAFE_DELETE_GPU_RESOURCE(_uploadTexture);
+            ClearUploads();
+            return;
+        }
+    }
+    const int32 cellSize = _cellWidth * _cellHeight;
+    const bool alpha8 = format == PixelFormat::R8_UNorm;
+    if (!alpha8)
+        _uploadsRGBA.Resize(cellSize);
+    const uint32 rowPitch = _cellWidth * (alpha8 ? sizeof(byte) : sizeof(uint32));
+    for (const Upload& upload : _uploads)
+    {
+        const byte* pixels = _uploadsPixels.Get() + upload.PixelsStart;
+        const void* data = pixels;
+        if (!alpha8)
+        {
+            // Render2D fallback uses RGBA atlas (the same as ImFontAtlas::GetTexDataAsRGBA32)
+            for (int32 i = 0; i < cellSize; i++)
+                _uploadsRGBA[i] = IM_COL32(255, 255, 255, pixels[i]);
+            data = _uploadsRGBA.Get();
+        }
+        const Slot& slot = _slots[upload.Slot];
+        context->UpdateTexture(_uploadTexture, 0, 0, data, rowPitch, rowPitch * _cellHeight);
+        context->CopyTexture(texture, 0, slot.X, slot.Y, 0, _uploadTexture, 0);
+    }
+    ClearUploads();
+}
+
+void ImGuiGlyphCache::OnGlyphMissing(ImFont* font, ImWchar c)
+{
+    auto cache = (ImGuiGlyphCache*)font->ContainerAtlas->GlyphMissingUserData;
+    cache->RequestGlyph(font, c);
+}
+
+ImGuiGlyphCache::FontData* ImGuiGlyphCache::GetFont(const ImFont* font)
+{
+    for (FontData& data : _fonts)
+    {
+        if (data.Font == font)
+            return &data;
+    }
+    return nullptr;
+}
+
+void ImGuiGlyphCache::RequestGlyph(ImFont* font, ImWchar c)
+{
+    FontData* data = GetFont(font);
+    if (!data || data->Requested.Contains(c))
+        return;
+
+    // Characters missing in the font files stay in the requested set so they are not checked again
+    data->Requested.Add(c);
+    for (int32 i = 0; i < _sources.Count(); i++)
+    {
+        const Source& source = _sources[i];
+        if (source.Font != font)
+            continue;
+        const int glyph = stbtt_FindGlyphIndex(source.Info, c);
+        if (glyph != 0)
+        {
+            Request& request = _requests.AddOne();
+            request.Source = i;
+            request.Codepoint = c;
+            request.Glyph = glyph;
+            break;
+        }
+    }
+}
+
+int32 ImGuiGlyphCache::FindSlot() const
+{
+    // Use a free slot or the least recently used one (not used by the frames that can still be drawn)
+    int32 result = -1;
+    int32 resultUse = Math::Min(_atlas->DynamicGlyphsFrame - IMGUI_DYNAMIC_GLYPHS_MIN_AGE, _keepFrame);
+    for (int32 i = 0; i < _slots.Count(); i++)
+    {
+        const Slot& slot = _slots[i];
+        if (!slot.Font)
+            return i;
+        const int32 lastUse = slot.Font->DynamicGlyphsLastUse[slot.Glyph - slot.Font->DynamicGlyphsStart];
+        if (lastUse < resultUse)
+        {
+            result = i;
+            resultUse = lastUse;
+        }
+    }
+    return result;
+}
+
+void ImGuiGlyphCache::EvictGlyph(Slot& slot)
+{
+    ImFont* font = slot.Font;
+    FontData* data = GetFont(font);
+    const ImWchar c = (ImWchar)font->Glyphs[slot.Glyph].Codepoint;
+    font->SetGlyphIndex(c, (ImWchar)-1, font->FallbackAdvanceX);
+    data->FreeGlyphs.Add(slot.Glyph);
+    data->Requested.Remove(c);
+    slot.Font = nullptr;
+    slot.Glyph = -1;
+    GlyphsCount--;
+}
+
+void ImGuiGlyphCache::AddGlyph(const Result& result)
+{
+    const Source& source = _sources[result.Source];
+    ImFont* font = source.Font;
+    FontData* data = GetFont(font);
+    const ImWchar c = result.Codepoint;
+    if (result.Width < 0)
+        return;
+    const int32 slotIndex = FindSlot();
+    if (slotIndex == -1)
+    {
+        // All glyphs are in use so request it again later
+        data->Requested.Remove(c);
+        return;
+    }
+    Slot& slot = _slots[slotIndex];
+    if (slot.Font)
+        EvictGlyph(slot);
+
+    // Add glyph to the font
+    int32 glyphIndex;
+    if (data->FreeGlyphs.HasItems())
+    {
+        glyphIndex = data->FreeGlyphs.Last();
+        data->FreeGlyphs.RemoveLast();
+    }
+    else
+    {
+        glyphIndex = font->Glyphs.Size;
+        font->Glyphs.resize(glyphIndex + 1);
+        font->DynamicGlyphsLastUse.resize(glyphIndex + 1 - font->DynamicGlyphsStart);
+    }
+    const int32 padding = _atlas->TexGlyphPadding;
+    const int32 x = slot.X + padding, y = slot.Y + padding;
+    ImFontGlyph& glyph = font->Glyphs[glyphIndex];
+    glyph.Codepoint = c;
+    glyph.Colored = 0;
+    glyph.Visible = result.X0 != result.X1 && result.Y0 != result.Y1;
+    glyph.X0 = result.X0;
+    glyph.Y0 = result.Y0;
+    glyph.X1 = result.X1;
+    glyph.Y1 = result.Y1;
+    glyph.U0 = (float)x * _atlas->TexUvScale.x;
+    glyph.V0 = (float)y * _atlas->TexUvScale.y;
+    glyph.U1 = (float)(x + result.Width) * _atlas->TexUvScale.x;
+    glyph.V1 = (float)(y + result.Height) * _atlas->TexUvScale.y;
+    glyph.AdvanceX = result.AdvanceX;
+    font->DynamicGlyphsLastUse[glyphIndex - font->DynamicGlyphsStart] = _atlas->DynamicGlyphsFrame;
+    slot.Font = font;
+    slot.Glyph = glyphIndex;
+    GlyphsCount++;
+
+    // Update font lookup
+    font->SetGlyphIndex(c, (ImWchar)glyphIndex, glyph.AdvanceX);
+    const int32 page = (int32)c / 4096;
+    font->Used4kPagesMap[page >> 3] |= 1 << (page & 7);
+
+    // Queue slot upload (replaces the pending one so uploads don't pile up while nothing is drawn)
+    if (slot.Upload == -1)
+    {
+        slot.Upload = _uploads.Count();
+        Upload& upload = _uploads.AddOne();
+        upload.Slot = slotIndex;
+        upload.PixelsStart = _uploadsPixels.Count();
+        _uploadsPixels.Resize(upload.PixelsStart + _cellWidth * _cellHeight);
+    }
+    byte* dst = _uploadsPixels.Get() + _uploads[slot.Upload].PixelsStart;
+    Platform::MemoryClear(dst, _cellWidth * _cellHeight);
+    const byte* src = _resultsPixels.Get() + result.PixelsStart;
+    for (int32 row = 0; row < result.Height; row++)
+        Platform::MemoryCopy(dst + (row + padding) * _cellWidth + padding, src + row * result.Width, result.Width);
+}
+
+void ImGuiGlyphCache::ClearUploads()
+{
+    for (const Upload& upload : _uploads)
+        _slots[upload.Slot].Upload = -1;
+    _uploads.Clear();
+    _uploadsPixels.Clear();
+}
+
+void ImGuiGlyphCache::Rasterize()
+{
+    PROFILE_CPU();
+    const int32 padding = _atlas->TexGlyphPadding;
+    const bool sdf = (_atlas->Flags & ImFontAtlasFlags_SignedDistanceField) != 0;
+    for (const Request& request : _batch)
+    {
+        const Source& source = _sources[request.Source];
+        const ImFontConfig& config = *source.Config;
+        const int32 oversampleH = sdf ? 1 : config.OversampleH, oversampleV = sdf ? 1 : config.OversampleV;
+        const float scaleH = source.Scale * (float)oversampleH, scaleV = source.Scale * (float)oversampleV;
+        Result& result = _results.AddOne();
+        result.Source = request.Source;
+        result.Codepoint = request.Codepoint;
+        result.PixelsStart = _resultsPixels.Count();
+
+        // Rasterize glyph (the same way as stbtt_PackFontRangesRenderIntoRects or ImFontAtlasBuildRenderGlyphsSDF does)
+        int x0 = 0, y0 = 0, width = 0, height = 0;
+        unsigned char* field = nullptr;
+        if (sdf)
+        {
+            field = stbtt_GetGlyphSDF(source.Info, source.Scale, request.Glyph, _atlas->TexSdfPadding, IM_FONT_SDF_ONEDGE_VALUE, IM_FONT_SDF_PIXEL_DIST_SCALE(_atlas->TexSdfPadding), &width, &height, &x0, &y0);
+        }
+        else
+        {
+            int x1, y1;
+            stbtt_GetGlyphBitmapBoxSubpixel(source.Info, request.Glyph, scaleH, scaleV, 0, 0, &x0, &y0, &x1, &y1);
+            width = Math::Max(x1 - x0 + oversampleH - 1, 0);
+            height = Math::Max(y1 - y0 + oversampleV - 1, 0);
+        }
+        if (width + padding > _cellWidth || height + padding > _cellHeight)
+        {
+            if (field)
+                stbtt_FreeSDF(field, nullptr);
+            result.Width = result.Height = -1;
+            continue;
+        }
+        result.Width = width;
+        result.Height = height;
+        _resultsPixels.Resize(result.PixelsStart + width * height);
+        byte* pixels = _resultsPixels.Get() + result.PixelsStart;
+        Platform::MemoryClear(pixels, width * height);
+        float subX = 0.0f, subY = 0.0f;
+        if (field)
+        {
+            Platform::MemoryCopy(pixels, field, width * height);
+            stbtt_FreeSDF(field, nullptr);
+        }
+        else if (width != 0 && height != 0)
+        {
+            stbtt_MakeGlyphBitmapSubpixelPrefilter(source.Info, pixels, width, height, width, scaleH, scaleV, 0, 0, oversampleH, oversampleV, &subX, &subY, request.Glyph);
+            if (config.RasterizerMultiply != 1.0f)
+                ImFontAtlasBuildMultiplyRectAlpha8(source.Multiply, pixels, 0, 0, width, height, width);
+        }
+
+        // Glyph metrics (the same way as ImFontAtlasBuildWithStbTruetype and ImFont::AddGlyph do)
+        const float recipH = 1.0f / (float)oversampleH, recipV = 1.0f / (float)oversampleV;
+        result.X0 = (float)x0 * recipH + subX + source.Offset.x;
+        result.Y0 = (float)y0 * recipV + subY + source.Offset.y;
+        result.X1 = (float)(x0 + width) * recipH + subX + source.Offset.x;
+        result.Y1 = (float)(y0 + height) * recipV + subY + source.Offset.y;
+        int advance, lsb;
+        stbtt_GetGlyphHMetrics(source.Info, request.Glyph, &advance, &lsb);
+        float advanceX = source.Scale * (float)advance;
+        const float advanceXOriginal = advanceX;
+        advanceX = ImClamp(advanceX, config.GlyphMinAdvanceX, config.GlyphMaxAdvanceX);
+        if (advanceX != advanceXOriginal)
+        {
+            const float offset = config.PixelSnapH ? ImFloor((advanceX - advanceXOriginal) * 0.5f) : (advanceX - advanceXOriginal) * 0.5f;
+            result.X0 += offset;
+            result.X1 += offset;
+        }
+        if (config.PixelSnapH)
+            advanceX = IM_ROUND(advanceX);
+        result.AdvanceX = advanceX + config.GlyphExtraSpacing.x;
+    }
+    Platform::AtomicStore(&_working, 0);
+}
@@ -0,0 +1,146 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/HashSet.h"
+#include "ImGui/imgui.h"
+
+class GPUContext;
+class GPUTexture;
+struct stbtt_fontinfo;
+
+#ifndef IMGUI_DYNAMIC_GLYPHS
+// The amount of font atlas slots reserved for glyphs rasterized on demand (0 to disable dynamic glyphs)
+#define IMGUI_DYNAMIC_GLYPHS 512
+#endif
+
+/// <summary>
+/// Cache of font glyphs rasterized on demand. Characters missing in the font atlas (eg. outside the font glyph ranges) are rasterized on a background thread into the slots reserved in the atlas texture. The least recently used glyphs are evicted when slots run out. Fallback glyph is displayed until the glyph is ready.
+/// </summary>
+class ImGuiGlyphCache
+{
+private:
+    struct Source
+    {
+        ImFont* Font;
+        const ImFontConfig* Config;
+        stbtt_fontinfo* Info;
+        float Scale;
+        ImVec2 Offset;
+        unsigned char Multiply[256];
+    };
+
+    struct FontData
+    {
+        ImFont* Font;
+        Array<int32> FreeGlyphs;
+        HashSet<ImWchar> Requested;
+    };
+
+    struct Slot
+    {
+        uint16 X, Y;
+        ImFont* Font;
+        int32 Glyph;
+        int32 Upload;
+    };
+
+    struct Request
+    {
+        int32 Source;
+        ImWchar Codepoint;
+        int32 Glyph;
+    };
+
+    struct Result
+    {
+        int32 Source;
+        ImWchar Codepoint;
+        int32 Width, Height;
+        int32 PixelsStart;
+        float X0, Y0, X1, Y1;
+        float AdvanceX;
+    };
+
+    struct Upload
+    {
+        int32 Slot;
+        int32 PixelsStart;
+    };
+
+    ImFontAtlas* _atlas = nullptr;
+    int32 _firstRect = -1;
+    int32 _cellWidth = 0;
+    int32 _cellHeight = 0;
+    int32 _keepFrame = MAX_int32;
+    Array<Source> _sources;
+    Array<FontData> _fonts;
+    Array<Slot> _slots;
+    Array<Request> _requests;
+
+    // Rasterization batch (owned by the background thread while it's working)
+    int64 volatile _working = 0;
+    Array<Request> _batch;
+    Array<Result> _results;
+    Array<byte> _resultsPixels;
+
+    // Slots to update in the atlas texture (only the latest glyph of the slot is uploaded)
+    Array<Upload> _uploads;
+    Array<byte> _uploadsPixels;
+    Array<uint32> _uploadsRGBA;
+    GPUTexture* _uploadTexture = nullptr;
+
+public:
+    /// <summary>
+    /// The amount of glyphs rasterized on demand that are resident in the font atlas.
+    /// </summary>
+    int32 GlyphsCount = 0;
+
+public:
+    /// <summary>
+    /// Reserves the glyph slots in the font atlas. Must be called after adding fonts and before building the atlas.
+    /// </summary>
+    /// <param name="atlas">The font atlas.</param>
+    void Init(ImFontAtlas* atlas);
+
+    /// <summary>
+    /// Starts adding missing glyphs to the fonts. Must be called after building the atlas.
+    /// </summary>
+    void Setup();
+
+    /// <summary>
+    /// Waits for the background rasterization and releases the resources.
+    /// </summary>
+    void Dispose();
+
+    /// <summary>
+    /// Adds the glyphs rasterized since the last update to the fonts and starts rasterization of the glyphs requested in the last frame. Called once per game update before ImGui frames begin.
+    /// </summary>
+    /// <param name="keepFrame">The oldest ImFontAtlas::DynamicGlyphsFrame of the frames that can still be drawn. Glyphs used since then are not evicted.</param>
+    void Update(int32 keepFrame = MAX_int32);
+
+    /// <summary>
+    /// Uploads the added glyphs into the font atlas texture. Must be called before drawing ImGui data that uses them.
+    /// </summary>
+    /// <param name="context">The GPU context.</param>
+    /// <param name="texture">The font atlas texture.</param>
+    void Flush(GPUContext* context, GPUTexture* texture);
+
+    /// <summary>
+    /// Checks if the font atlas custom rectangle is a glyph slot reserved by the cache.
+    /// </summary>
+    /// <param name="index">The custom rectangle index.</param>
+    /// <returns>True if rectangle is a glyph slot, otherwise false.</returns>
+    bool IsSlotRect(int32 index) const;
+
+private:
+    static void OnGlyphMissing(ImFont* font, ImWchar c);
+    FontData* GetFont(const ImFont* font);
+    void RequestGlyph(ImFont* font, ImWchar c);
+    int32 FindSlot() const;
+    void EvictGlyph(Slot& slot);
+    void AddGlyph(const Result& result);
+    void ClearUploads();
+    void Rasterize();
+};
@@ -1,9 +1,13 @@
 ﻿// Copyright (c) Wojciech Figat. All rights reserved.
 
 #include "ImGuiPlugin.h"
+#include "ImGuiFontAtlasCache.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Types/DataContainer.h"
+#include "Engine/Content/Content.h"
+#include "Engine/Content/Assets/RawDataAsset.h"
 #include "Engine/Engine/Engine.h"
+#include "Engine/Engine/Globals.h"
 #include "Engine/Engine/Screen.h"
 #include "Engine/Engine/Time.h"
 #include "Engine/Graphics/GPUDevice.h"
@@ -12,11 +16,20 @@
 #include "Engine/Graphics/Textures/GPUTexture.h"
 #include "Engine/Input/Input.h"
 #include "Engine/Profiler/Profiler.h"
-#include "Engine/Render2D/Render2D.h"
 #include "Engine/Scripting/Plugins/PluginManager.h"
+#include "Engine/Threading/JobSystem.h"
+#include "Engine/Threading/Task.h"
 #include "ImGui/imgui.h"
 #include "ImGui/imgui_internal.h"
 
+// Font atlas baked by the Editor (fonts rasterization is skipped at runtime if it matches the fonts configuration)
+#define IMGUI_FONT_ATLAS_PATH TEXT("Content/ImGui/FontAtlas.flax")
+
+#ifndef IMGUI_FONT_SDF
+// Builds the font atlas with signed distance field glyphs so text stays sharp at any scale (eg. FontGlobalScale from DPI) without atlases per size (requires shader, Render2D fallback uses bitmap glyphs)
+#define IMGUI_FONT_SDF 0
+#endif
+
 struct ImGuiKeyMapping
 {
     ImGuiKey ImGui;
@@ -49,6 +62,105 @@ ImGuiKeyMapping KeyMappings[] =
     { ImGuiKey_RightBracket, KeyboardKeys::RightBracket },
 };
 
+struct ImGuiFontBuildJob
+{
+    void (*Func)(void* data, int index);
+    void* Data;
+
+    void Run(int32 index)
+    {
+        Func(Data, index);
+    }
+};
+
+void ImGuiFontBuildParallelFor(int count, void (*func)(void* data, int index), void* data, void* userData)
+{
+    // Rasterize source fonts of the atlas on Job System
+    ImGuiFontBuildJob job = { func, data };
+    Function<void(int32)> action;
+    action.Bind<ImGuiFontBuildJob, &ImGuiFontBuildJob::Run>(&job);
+    JobSystem::Wait(JobSystem::Dispatch(action, count));
+}
+
+// Copies the fonts and settings of the font atlas (font sizes are scaled) into the other atlas before it's built
+void CopyFontAtlas(ImFontAtlas* dst, const ImFontAtlas* src, float scale, bool copyFontData, const ImGuiGlyphCache* glyphCache)
+{
+    dst->Flags = src->Flags;
+    dst->TexDesiredWidth = src->TexDesiredWidth;
+    dst->TexGlyphPadding = src->TexGlyphPadding;
+    dst->TexSdfPadding = src->TexSdfPadding;
+    dst->FontBuilderIO = src->FontBuilderIO;
+    dst->FontBuilderFlags = src->FontBuilderFlags;
+    dst->BuildParallelFor = src->BuildParallelFor;
+    for (const ImFontConfig& config : src->ConfigData)
+    {
+        ImFontConfig copy = config;
+        copy.DstFont = nullptr;
+        copy.FontDataOwnedByAtlas = copyFontData;
+        if (copyFontData)
+        {
+            copy.FontData = IM_ALLOC(config.FontDataSize);
+            Platform::MemoryCopy(copy.FontData, config.FontData, config.FontDataSize);
+        }
+        if (scale != 1.0f)
+        {
+            copy.SizePixels *= scale;
+            copy.GlyphOffset = ImVec2(copy.GlyphOffset.x * scale, copy.GlyphOffset.y * scale);
+            copy.GlyphExtraSpacing = ImVec2(copy.GlyphExtraSpacing.x * scale, copy.GlyphExtraSpacing.y * scale);
+            copy.GlyphMinAdvanceX *= scale;
+            if (copy.GlyphMaxAdvanceX < FLT_MAX)
+                copy.GlyphMaxAdvanceX *= scale;
+        }
+        dst->AddFont(&copy);
+    }
+    for (const ImFontAtlasCustomRect& rect : src->CustomRects)
+    {
+        // Skip built-in rectangles (added during build) and glyph cache slots (reserved again by the cache of the new atlas)
+        const int32 index = src->CustomRects.index_from_ptr(&rect);
+        if (index == src->PackIdMouseCursors || index == src->PackIdLines || (glyphCache && glyphCache->IsSlotRect(index)))
+            continue;
+        if (rect.Font)
+            dst->AddCustomRectFontGlyph(dst->Fonts[src->Fonts.index_from_ptr(src->Fonts.find(rect.Font))], (ImWchar)rect.GlyphID, rect.Width, rect.Height, rect.GlyphAdvanceX * scale, ImVec2(rect.GlyphOffset.x * scale, rect.GlyphOffset.y * scale));
+        else
+            dst->AddCustomRectRegular(rect.Width, rect.Height);
+    }
+}
+
+// Replaces the font references in the atlas inputs
+void RemapFontAtlasFont(ImFontAtlas* atlas, const ImFont* font, ImFont* newFont)
+{
+    for (ImFontConfig& config : atlas->ConfigData)
+    {
+        if (config.DstFont == font)
+            config.DstFont = newFont;
+    }
+    for (ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    {
+        if (rect.Font == font)
+            rect.Font = newFont;
+    }
+}
+
+// Moves the built fonts of the new atlas into the font objects of the used atlas (copied with CopyFontAtlas) so ImFont pointers held by game code stay valid
+void SwapFontAtlasFonts(ImFontAtlas* atlas, ImFontAtlas* newAtlas)
+{
+    const int32 count = Math::Min(atlas->Fonts.Size, newAtlas->Fonts.Size);
+    for (int32 i = 0; i < count; i++)
+    {
+        // Fonts don't point to themselves (glyphs, configs and atlas pointers follow the swapped contents)
+        ImFont* font = atlas->Fonts[i];
+        ImFont* newFont = newAtlas->Fonts[i];
+        alignas(ImFont) byte tmp[sizeof(ImFont)];
+        Platform::MemoryCopy(tmp, (void*)font, sizeof(ImFont));
+        Platform::MemoryCopy((void*)font, newFont, sizeof(ImFont));
+        Platform::MemoryCopy((void*)newFont, tmp, sizeof(ImFont));
+        atlas->Fonts[i] = newFont;
+        newAtlas->Fonts[i] = font;
+        RemapFontAtlasFont(atlas, font, newFont);
+        RemapFontAtlasFont(newAtlas, newFont, font);
+    }
+}
+
 ImGuiPlugin::ImGuiPlugin(const SpawnParams& params)
     : GamePlugin(params)
 {
@@ -76,31 +188,47 @@ void ImGuiPlugin::Initialize()
 {
     GamePlugin::Initialize();
 
-    // Initialize
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-    io.FontGlobalScale = Platform::GetDpiScale();
+    // Initialize (font atlas height isn't rounded to the power of two which saves up to half of the texture memory)
+    _dpiScale = Platform::GetDpiScale();
+    _fontAtlas = IM_NEW(ImFontAtlas)();
+    _fontAtlas->Flags |= ImFontAtlasFlags_NoPowerOfTwoHeight;
+    _fontAtlas->BuildParallelFor = ImGuiFontBuildParallelFor;
+    _glyphCache = New<ImGuiGlyphCache>();
     Engine::Update.Bind<ImGuiPlugin, &ImGuiPlugin::OnUpdate>(this);
     Engine::LateUpdate.Bind<ImGuiPlugin, &ImGuiPlugin::OnLateUpdate>(this);
-    MainRenderTask::Instance->PostRender.Bind<ImGuiPlugin, &ImGuiPlugin::OnPostRender>(this);
+    CreateContext(MainRenderTask::Instance);
+    ImGui::SetCurrentContext(_contexts[0]->Context);
 
-    // Setup font atlas texture
-    int width, height;
-    unsigned char* pixels = nullptr;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-    _fontAtlasTexture = GPUDevice::Instance->CreateTexture(TEXT("ImGui.FontAtlas"));
-    if (_fontAtlasTexture->Init(GPUTextureDescription::New2D(width, height, 1, PixelFormat::R8G8B8A8_UNorm, GPUTextureFlags::ShaderResource)))
+    // Setup font atlas texture (shared by all contexts)
+    if (_fontAtlas->ConfigData.empty())
+        _fontAtlas->AddFontDefault();
+
+    // Use single-channel atlas when drawing directly (Render2D fallback supports only RGBA textures), shader keeps loading in the background
+    _fontAtlasAlpha8 = _contexts[0]->Renderer.HasNative();
+#if IMGUI_FONT_SDF
+    if (_fontAtlasAlpha8)
     {
-        LOG(Error, "Failed to setup ImGui font atlas texture.");
-        return;
+        _fontAtlas->Flags |= ImFontAtlasFlags_SignedDistanceField | ImFontAtlasFlags_NoBakedLines;
+        _contexts[0]->Renderer.FontSDF = true;
     }
-    BytesContainer data;
-    data.Link(pixels, width * height * sizeof(uint32));
-    auto task = _fontAtlasTexture->UploadMipMapAsync(data, 0, true);
-    if (task)
-        task->Start();
-    io.Fonts->SetTexID(_fontAtlasTexture);
+#endif
+    _glyphCache->Init(_fontAtlas);
+    const bool baked = LoadFontAtlas();
+#if USE_EDITOR
+    // Build the atlas to bake it before upload releases its texture data
+    if (!baked && _fontAtlas->Build())
+        SaveFontAtlas(_fontAtlas);
+#endif
+    _fontAtlasTexture = UploadFontAtlas(_fontAtlas);
+    if (!_fontAtlasTexture)
+        return;
+
+    // Rasterize glyphs missing in the atlas on demand
+    _glyphCache->Setup();
+
+    // Fonts are added at DPI scale 1 so rebuild the atlas in the background for high-DPI displays (scaled glyphs are drawn until then)
+    if (_dpiScale != 1.0f && !(_fontAtlas->Flags & ImFontAtlasFlags_SignedDistanceField))
+        _fontAtlasRebuild = true;
 
     // Run initial frame
     OnUpdate();
@@ -111,131 +239,609 @@ void ImGuiPlugin::Deinitialize()
     // Shutdown
     Engine::Update.Unbind<ImGuiPlugin, &ImGuiPlugin::OnUpdate>(this);
     Engine::LateUpdate.Unbind<ImGuiPlugin, &ImGuiPlugin::OnLateUpdate>(this);
-    MainRenderTask::Instance->PostRender.Unbind<ImGuiPlugin, &ImGuiPlugin::OnPostRender>(this);
-    ImGui::DestroyContext();
+    for (int32 i = _contexts.Count() - 1; i >= 0; i--)
+        ReleaseContext(_contexts[i]);
+    while (Platform::AtomicRead(&_fontAtlasBuilding) != 0)
+        Platform::Sleep(1);
+    ReleaseNewFontAtlas();
+    for (ImFontConfig& config : _newFonts)
+        IM_FREE(config.FontData);
+    _newFonts.Clear();
+    _glyphCache->Dispose();
+    Delete(_glyphCache);
+    _glyphCache = nullptr;
+    IM_DELETE(_fontAtlas);
+    _fontAtlas = nullptr;
     SAFE_DELETE_GPU_RESOURCE(_fontAtlasTexture);
+    SAFE_DELETE_GPU_RESOURCE(_oldFontAtlasTexture);
 
     GamePlugin::Deinitialize();
 }
 
+bool ImGuiPlugin::IsUpdating() const
+{
+    const ContextData* context = GetContext(GetCurrentContext());
+    return context && context->ActiveFrame;
+}
+
+ImGuiStats ImGuiPlugin::GetStats() const
+{
+    ImGuiStats result;
+    for (const ContextData* e : _contexts)
+    {
+        result.VerticesCount += e->Stats.VerticesCount;
+        result.IndicesCount += e->Stats.IndicesCount;
+        result.DrawListsCount += e->Stats.DrawListsCount;
+        result.FrameTime += e->Stats.FrameTime;
+        result.DrawCommandsCount += e->Renderer.DrawCommandsCount;
+        result.DrawCallsCount += e->Renderer.DrawCallsCount;
+        result.ClipPushesCount += e->Renderer.ClipPushesCount;
+        result.UploadedVerticesCount += e->Renderer.UploadedVerticesCount;
+        result.ConvertTime += e->Renderer.ConvertTime;
+    }
+    result.AtlasMemory = _fontAtlasTexture ? _fontAtlasTexture->GetMemoryUsage() : 0;
+    result.AtlasOccupancy = _fontAtlas ? _fontAtlas->TexOccupancy : 0.0f;
+    result.DynamicGlyphsCount = _glyphCache ? _glyphCache->GlyphsCount : 0;
+    return result;
+}
+
+int32 ImGuiPlugin::CreateContext(SceneRenderTask* task)
+{
+    if (!task || !_fontAtlas)
+        return -1;
+    for (const ContextData* e : _contexts)
+    {
+        if (e->Task == task)
+        {
+            LOG(Warning, "ImGui context is already attached to the render task.");
+            return e->ID;
+        }
+    }
+
+    // Create context (shares the font atlas with other contexts)
+    auto context = New<ContextData>();
+    context->ID = _contextsCounter++;
+    context->Context = ImGui::CreateContext(_fontAtlas);
+    context->Task = task;
+    context->EnableInput = context->ID == 0;
+    ImGuiContext* prevContext = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(context->Context);
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    io.FontGlobalScale = _dpiScale / _fontAtlasScale;
+    ImGui::SetCurrentContext(prevContext);
+    context->Renderer.Init();
+    context->Renderer.FontSDF = (_fontAtlas->Flags & ImFontAtlasFlags_SignedDistanceField) != 0;
+    task->PostRender.Bind<ImGuiPlugin, &ImGuiPlugin::OnPostRender>(this);
+    _contexts.Add(context);
+    return context->ID;
+}
+
+void ImGuiPlugin::DestroyContext(int32 id)
+{
+    ContextData* context = GetContext(id);
+    if (id == 0 || !context)
+    {
+        LOG(Warning, "Cannot destroy ImGui context {0}.", id);
+        return;
+    }
+    ReleaseContext(context);
+}
+
+int32 ImGuiPlugin::GetCurrentContext() const
+{
+    const ImGuiContext* current = ImGui::GetCurrentContext();
+    for (const ContextData* e : _contexts)
+    {
+        if (e->Context == current)
+            return e->ID;
+    }
+    return -1;
+}
+
+void ImGuiPlugin::SetCurrentContext(int32 id)
+{
+    const ContextData* context = GetContext(id);
+    if (!context)
+    {
+        LOG(Warning, "Missing ImGui context {0}.", id);
+        return;
+    }
+    ImGui::SetCurrentContext(context->Context);
+}
+
+void ImGuiPlugin::SetContextInput(int32 id, bool enable)
+{
+    ContextData* context = GetContext(id);
+    if (context)
+        context->EnableInput = enable;
+}
+
+void ImGuiPlugin::SetContextMousePosition(int32 id, const Float2& position)
+{
+    ContextData* context = GetContext(id);
+    if (context)
+    {
+        context->CustomMousePosition = true;
+        context->MousePosition = position;
+    }
+}
+
+void ImGuiPlugin::ResetContextMousePosition(int32 id)
+{
+    ContextData* context = GetContext(id);
+    if (context)
+        context->CustomMousePosition = false;
+}
+
+#if USE_EDITOR
+
+bool ImGuiPlugin::BakeFontAtlas()
+{
+    if (!_fontAtlas)
+        return true;
+    PROFILE_CPU();
+
+    // Build a temporary atlas with the same fonts (texture data of the used atlas is released after upload)
+    ImFontAtlas atlas;
+    CopyFontAtlas(&atlas, _fontAtlas, 1.0f, false, nullptr);
+    if (!atlas.Build())
+        return true;
+    return SaveFontAtlas(&atlas);
+}
+
+bool ImGuiPlugin::SaveFontAtlas(const ImFontAtlas* atlas)
+{
+    auto asset = Content::CreateVirtualAsset<RawDataAsset>();
+    if (!asset)
+        return true;
+    bool failed = ImGuiFontAtlasCache::Save(atlas, asset->Data);
+    if (!failed)
+        failed = asset->Save(Globals::ProjectFolder / IMGUI_FONT_ATLAS_PATH);
+    asset->DeleteObject();
+    if (failed)
+        LOG(Error, "Failed to bake ImGui font atlas.");
+    else
+        LOG(Info, "Baked ImGui font atlas to {0}", IMGUI_FONT_ATLAS_PATH);
+    return failed;
+}
+
+#endif
+
+bool ImGuiPlugin::LoadFontAtlas()
+{
+    PROFILE_CPU();
+
+    // Load via content (not as a file) as the asset is packaged in cooked games, it's missing if loading fails
+    auto asset = Content::LoadAsync<RawDataAsset>(Globals::ProjectFolder / IMGUI_FONT_ATLAS_PATH);
+    if (!asset || asset->WaitForLoaded())
+        return false;
+    if (ImGuiFontAtlasCache::Load(_fontAtlas, Span<byte>(asset->Data.Get(), asset->Data.Count())))
+    {
+        LOG(Info, "ImGui font atlas {0} doesn't match fonts configuration. Building it at runtime.", IMGUI_FONT_ATLAS_PATH);
+        return false;
+    }
+    return true;
+}
+
+void ImGuiPlugin::RebuildFontAtlas()
+{
+    _fontAtlasRebuild = true;
+}
+
+void ImGuiPlugin::AddFont(const ImFontConfig& config)
+{
+    if (!config.FontData || config.FontDataSize <= 0)
+    {
+        LOG(Warning, "Missing ImGui font data.");
+        return;
+    }
+    ImFontConfig& copy = _newFonts.AddOne();
+    copy = config;
+    copy.DstFont = nullptr;
+    copy.FontDataOwnedByAtlas = true;
+    copy.FontData = IM_ALLOC(config.FontDataSize);
+    Platform::MemoryCopy(copy.FontData, config.FontData, config.FontDataSize);
+    _fontAtlasRebuild = true;
+}
+
+GPUTexture* ImGuiPlugin::UploadFontAtlas(ImFontAtlas* atlas) const
+{
+    // Use single-channel atlas when drawing directly (Render2D fallback supports only RGBA textures)
+    int width, height;
+    unsigned char* pixels = nullptr;
+    if (_fontAtlasAlpha8)
+        atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+    else
+        atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    GPUTexture* texture = GPUDevice::Instance->CreateTexture(TEXT("ImGui.FontAtlas"));
+    if (texture->Init(GPUTextureDescription::New2D(width, height, 1, _fontAtlasAlpha8 ? PixelFormat::R8_UNorm : PixelFormat::R8G8B8A8_UNorm, GPUTextureFlags::ShaderResource)))
+    {
+        LOG(Error, "Failed to setup ImGui font atlas texture.");
+        SAFE_DELETE_GPU_RESOURCE(texture);
+        return nullptr;
+    }
+    BytesContainer data;
+    data.Link(pixels, width * height * (_fontAtlasAlpha8 ? sizeof(byte) : sizeof(uint32)));
+    auto task = texture->UploadMipMapAsync(data, 0, true);
+    if (task)
+        task->Start();
+    atlas->SetTexID(texture);
+
+    // Release the CPU copy of the atlas (upload task copies the data, and atlas gets locked by the first frame)
+    atlas->ClearTexData();
+    return texture;
+}
+
+void ImGuiPlugin::UpdateFontAtlas()
+{
+    // Scale fonts with DPI (atlas is rebuilt at the new size unless it uses signed distance fields that scale without blur)
+    const float dpiScale = Platform::GetDpiScale();
+    if (dpiScale != _dpiScale)
+    {
+        _dpiScale = dpiScale;
+        for (ContextData* context : _contexts)
+            context->Context->IO.FontGlobalScale = _dpiScale / _fontAtlasScale;
+        if (!(_fontAtlas->Flags & ImFontAtlasFlags_SignedDistanceField))
+            _fontAtlasRebuild = true;
+    }
+
+    // Rebuild the atlas as RGBA without signed distance fields if the shader failed to load (Render2D fallback is used)
+    if (_fontAtlasAlpha8 && !_newFontAtlas && !_contexts[0]->Renderer.HasNative())
+    {
+        _fontAtlasAlpha8 = false;
+        for (ContextData* context : _contexts)
+            context->Renderer.FontSDF = false;
+        _fontAtlasRebuild = true;
+    }
+
+    // Release the texture of the previous atlas once no context draws a frame built with it (contexts that didn't draw since the last update drop such frames)
+    bool oldFontAtlasUsed = false;
+    for (ContextData* context : _contexts)
+    {
+        if (context->OldFontAtlas)
+        {
+            if (context->Drawn)
+            {
+                oldFontAtlasUsed = true;
+            }
+            else
+            {
+                context->DrawData.Clear();
+                context->OldFontAtlas = false;
+            }
+        }
+    }
+    if (_oldFontAtlasTexture && !oldFontAtlasUsed)
+        SAFE_DELETE_GPU_RESOURCE(_oldFontAtlasTexture);
+
+    if (_newFontAtlas)
+    {
+        if (Platform::AtomicRead(&_fontAtlasBuilding) != 0)
+            return;
+        if (!_newFontAtlasTexture)
+        {
+            // Upload the atlas built in the background (texture data has been already converted)
+            PROFILE_CPU_NAMED("UploadFontAtlas");
+            if (_newFontAtlas->IsBuilt())
+                _newFontAtlasTexture = UploadFontAtlas(_newFontAtlas);
+            if (!_newFontAtlasTexture)
+            {
+                LOG(Error, "Failed to rebuild ImGui font atlas.");
+                ReleaseNewFontAtlas();
+                return;
+            }
+        }
+
+        // Swap atlas at the frame boundary once it's resident on GPU (the current atlas is drawn until then)
+        if (!_newFontAtlasTexture->HasResidentMip() || _fontAtlas->Locked)
+            return;
+        PROFILE_CPU_NAMED("SwapFontAtlas");
+        for (ContextData* context : _contexts)
+        {
+            ImGuiIO& io = context->Context->IO;
+            io.Fonts = _newFontAtlas;
+            io.FontGlobalScale = _dpiScale / _newFontAtlasScale;
+            context->OldFontAtlas = true;
+        }
+        _glyphCache->Dispose();
+        Delete(_glyphCache);
+        SwapFontAtlasFonts(_fontAtlas, _newFontAtlas);
+        IM_DELETE(_fontAtlas);
+        _oldFontAtlasTexture = _fontAtlasTexture;
+        _fontAtlas = _newFontAtlas;
+        _fontAtlasTexture = _newFontAtlasTexture;
+        _fontAtlasScale = _newFontAtlasScale;
+        _glyphCache = _newGlyphCache;
+        _newFontAtlas = nullptr;
+        _newFontAtlasTexture = nullptr;
+        _newGlyphCache = nullptr;
+
+        // Rasterize glyphs missing in the new atlas on demand (after the swap so the cache uses the kept font objects)
+        _glyphCache->Setup();
+        return;
+    }
+
+    // Start building the new atlas in the background (with font sizes matching the current DPI scale)
+    if (!_fontAtlasRebuild)
+        return;
+    PROFILE_CPU_NAMED("RebuildFontAtlas");
+    _fontAtlasRebuild = false;
+    const bool sdf = _fontAtlasAlpha8 && (_fontAtlas->Flags & ImFontAtlasFlags_SignedDistanceField);
+    _newFontAtlasScale = sdf ? _fontAtlasScale : _dpiScale;
+    _newFontAtlas = IM_NEW(ImFontAtlas)();
+    CopyFontAtlas(_newFontAtlas, _fontAtlas, _newFontAtlasScale / _fontAtlasScale, true, _glyphCache);
+    if (!sdf && (_fontAtlas->Flags & ImFontAtlasFlags_SignedDistanceField))
+        _newFontAtlas->Flags &= ~(ImFontAtlasFlags_SignedDistanceField | ImFontAtlasFlags_NoBakedLines);
+    for (ImFontConfig& config : _newFonts)
+    {
+        config.SizePixels *= _newFontAtlasScale;
+        _newFontAtlas->AddFont(&config);
+    }
+    _newFonts.Clear();
+
+    // Source fonts are processed sequentially on the worker thread (waiting for other jobs within a job could deadlock)
+    _newFontAtlas->BuildParallelFor = nullptr;
+    _newGlyphCache = New<ImGuiGlyphCache>();
+    _newGlyphCache->Init(_newFontAtlas);
+    Platform::AtomicStore(&_fontAtlasBuilding, 1);
+    Function<void()> action;
+    action.Bind<ImGuiPlugin, &ImGuiPlugin::BuildNewFontAtlas>(this);
+    if (!Task::StartNew(action))
+        BuildNewFontAtlas();
+}
+
+void ImGuiPlugin::BuildNewFontAtlas()
+{
+    PROFILE_CPU();
+
+    // Build the atlas and convert its texture data on a worker thread (allocations don't access the ImGui context used by the main thread)
+    int width, height;
+    unsigned char* pixels = nullptr;
+    if (_newFontAtlas->Build())
+    {
+        if (_fontAtlasAlpha8)
+            _newFontAtlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+        else
+            _newFontAtlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+    Platform::AtomicStore(&_fontAtlasBuilding, 0);
+}
+
+void ImGuiPlugin::ReleaseNewFontAtlas()
+{
+    if (_newGlyphCache)
+    {
+        _newGlyphCache->Dispose();
+        Delete(_newGlyphCache);
+        _newGlyphCache = nullptr;
+    }
+    if (_newFontAtlas)
+    {
+        IM_DELETE(_newFontAtlas);
+        _newFontAtlas = nullptr;
+    }
+    SAFE_DELETE_GPU_RESOURCE(_newFontAtlasTexture);
+}
+
 bool ImGuiPlugin::IsReady()
 {
     return _fontAtlasTexture && _fontAtlasTexture->HasResidentMip();
 }
 
+ImGuiPlugin::ContextData* ImGuiPlugin::GetContext(int32 id) const
+{
+    for (ContextData* e : _contexts)
+    {
+        if (e->ID == id)
+            return e;
+    }
+    return nullptr;
+}
+
+void ImGuiPlugin::ReleaseContext(ContextData* context)
+{
+    if (context->Task)
+        context->Task->PostRender.Unbind<ImGuiPlugin, &ImGuiPlugin::OnPostRender>(this);
+    const bool isCurrent = ImGui::GetCurrentContext() == context->Context;
+    context->DrawData.Clear();
+    ImGui::DestroyContext(context->Context);
+    context->Renderer.Dispose();
+    _contexts.RemoveAtKeepOrder(_contexts.Find(context));
+    Delete(context);
+    if (isCurrent && _contexts.HasItems())
+        ImGui::SetCurrentContext(_contexts[0]->Context);
+}
+
 void ImGuiPlugin::OnUpdate()
 {
     PROFILE_CPU();
 
+    // Remove contexts which render tasks were deleted
+    for (int32 i = _contexts.Count() - 1; i > 0; i--)
+    {
+        if (!_contexts[i]->Task)
+            ReleaseContext(_contexts[i]);
+    }
+
+    // Swap the font atlas rebuilt in the background before frames begin
+    UpdateFontAtlas();
+
+    // Add glyphs rasterized on demand before fonts get used (glyphs of the frames still drawn by contexts are kept, eg. when updating at reduced rate)
+    int32 glyphsFrame = MAX_int32;
+    for (const ContextData* context : _contexts)
+    {
+        if (context->Drawn && !context->OldFontAtlas)
+            glyphsFrame = Math::Min(glyphsFrame, context->GlyphsFrame);
+    }
+    _glyphCache->Update(glyphsFrame);
+
+    // Begin frame of all contexts
+    const float deltaTime = Time::Update.UnscaledDeltaTime.GetTotalSeconds();
+    for (ContextData* context : _contexts)
+    {
+        context->Drawn = false;
+        ImGui::SetCurrentContext(context->Context);
+        UpdateContext(context, deltaTime);
+    }
+
+    // Game code uses the main context by default
+    ImGui::SetCurrentContext(_contexts[0]->Context);
+
+    //ImGui::ShowDemoWindow();
+}
+
+void ImGuiPlugin::UpdateContext(ContextData* context, float deltaTime)
+{
+    // Skip frames when updating at reduced rate (input events are queued until the next frame)
+    context->UpdateTime += deltaTime;
+    context->IdleTime += deltaTime;
+    const float updateInterval = UpdateRate > 0.0f ? 1.0f / UpdateRate : 0.0f;
+    bool beginFrame = context->UpdateTime >= updateInterval;
+
     // Begin frame
-    _activeFrame = true;
     ImGuiIO& io = ImGui::GetIO();
-    io.DeltaTime = Time::Update.UnscaledDeltaTime.GetTotalSeconds();
-    const Float2 screenSize = Screen::GetSize();
+    const Viewport viewport = context->ID == 0 ? Viewport(Screen::GetSize()) : context->Task->GetOutputViewport();
+    const Float2 screenSize = viewport.GetSize();
     io.DisplaySize.x = screenSize.X;
     io.DisplaySize.y = screenSize.Y;
-    const bool hasFocus = Engine::HasGameViewportFocus() && EnableInput && Enable;
+    io.ConfigTextSizeCache = EnableTextSizeCache;
+    io.ConfigTextLayoutCache = EnableTextLayoutCache;
+    const bool hasFocus = Engine::HasGameViewportFocus() && EnableInput && context->EnableInput && Enable;
     io.AddFocusEvent(hasFocus);
+    bool hasInput = false;
     if (hasFocus)
     {
         // Send input events
-        const Float2 mousePos = Input::GetMousePosition();
-        io.AddMousePosEvent(mousePos.X, mousePos.Y);
-        io.AddMouseButtonEvent(0, Input::GetMouseButton(MouseButton::Left));
-        io.AddMouseButtonEvent(1, Input::GetMouseButton(MouseButton::Right));
-        io.AddMouseWheelEvent(0, Input::GetMouseScrollDelta());
+        const bool mouseLeft = Input::GetMouseButton(MouseButton::Left);
+        const bool mouseRight = Input::GetMouseButton(MouseButton::Right);
+        const float mouseWheel = Input::GetMouseScrollDelta();
         const StringView inputText = Input::GetInputText();
+        hasInput = mouseLeft || mouseRight || mouseWheel != 0.0f || inputText.Length() != 0;
+        if (!context->Idle || hasInput)
+        {
+            // Mouse position is not queued while idle (it's not interacting with anything)
+            Float2 mousePos = context->MousePosition;
+            if (!context->CustomMousePosition)
+            {
+                mousePos = Input::GetMousePosition();
+                mousePos.X -= viewport.X;
+                mousePos.Y -= viewport.Y;
+            }
+            io.AddMousePosEvent(mousePos.X, mousePos.Y);
+        }
+        io.AddMouseButtonEvent(0, mouseLeft);
+        io.AddMouseButtonEvent(1, mouseRight);
+        io.AddMouseWheelEvent(0, mouseWheel);
         if (inputText.Length() != 0)
             io.AddInputCharacterUTF16(inputText[0]);
         for (const auto& e : KeyMappings)
         {
             if (Input::GetKeyDown(e.Flax))
+            {
                 io.AddKeyEvent(e.ImGui, true);
+                hasInput = true;
+            }
             else if (Input::GetKeyUp(e.Flax))
                 io.AddKeyEvent(e.ImGui, false);
         }
     }
-    ImGui::NewFrame();
 
-    //ImGui::ShowDemoWindow();
+    // Skip frames while idle (input wakes it up, otherwise it checks for windows opened by game code at IdleCheckRate)
+    if (context->Idle && EnableIdleMode && !hasInput && context->IdleTime < 1.0f / Math::Max(IdleCheckRate, ZeroTolerance))
+        beginFrame = false;
+    if (!beginFrame)
+        return;
+    context->IdleTime = 0.0f;
+    context->ActiveFrame = true;
+    io.DeltaTime = Math::Max(context->UpdateTime, ZeroTolerance);
+    context->UpdateTime = updateInterval > 0.0f ? Math::Min(context->UpdateTime - updateInterval, updateInterval) : 0.0f;
+    context->FrameStartTime = Platform::GetTimeSeconds();
+    PROFILE_CPU_NAMED("NewFrame");
+    ImGui::NewFrame();
 }
 
 void ImGuiPlugin::OnLateUpdate()
 {
-    if (!_activeFrame)
-        return;
     PROFILE_CPU();
+    for (ContextData* context : _contexts)
+    {
+        if (!context->ActiveFrame)
+            continue;
+        ImGui::SetCurrentContext(context->Context);
 
-    // End frame
-    if (ImGui::GetCurrentWindowRead() == nullptr)
-        return;
-    ImGui::EndFrame();
-    _activeFrame = false;
+        // End frame
+        if (ImGui::GetCurrentWindowRead() == nullptr)
+            continue;
+        ImGui::EndFrame();
+        context->ActiveFrame = false;
 
-    if (!IsReady() || !Enable)
-        return;
-    ImGui::Render();
+        if (!IsReady() || !Enable)
+            continue;
+        {
+            PROFILE_CPU_NAMED("Render");
+            ImGui::Render();
+        }
+
+        // Copy draw data so it can be rendered while the next frame is being built
+        const ImDrawData* drawData = ImGui::GetDrawData();
+        context->DrawData.Push(drawData);
+        context->OldFontAtlas = false;
+        context->GlyphsFrame = _fontAtlas->DynamicGlyphsFrame;
+        context->Stats.VerticesCount = drawData->TotalVtxCount;
+        context->Stats.IndicesCount = drawData->TotalIdxCount;
+        context->Stats.DrawListsCount = drawData->CmdListsCount;
+        context->Stats.FrameTime = (float)((Platform::GetTimeSeconds() - context->FrameStartTime) * 1000.0);
+
+        // Enter idle mode when nothing has been drawn (no visible windows)
+        context->Idle = EnableIdleMode && drawData->CmdListsCount == 0;
+    }
+    if (_contexts.HasItems())
+        ImGui::SetCurrentContext(_contexts[0]->Context);
+
+#if COMPILE_WITH_PROFILER
+    // Publish statistics to the profiler (drawing stats come from the previous frame)
+    const ImGuiStats stats = GetStats();
+    TracyPlot("ImGui Vertices", (int64)stats.VerticesCount);
+    TracyPlot("ImGui Indices", (int64)stats.IndicesCount);
+    TracyPlot("ImGui Draw Lists", (int64)stats.DrawListsCount);
+    TracyPlot("ImGui Draw Commands", (int64)stats.DrawCommandsCount);
+    TracyPlot("ImGui Draw Calls", (int64)stats.DrawCallsCount);
+    TracyPlot("ImGui Clip Pushes", (int64)stats.ClipPushesCount);
+    TracyPlot("ImGui Uploaded Vertices", (int64)stats.UploadedVerticesCount);
+    TracyPlot("ImGui Convert Time", stats.ConvertTime);
+    TracyPlot("ImGui Frame Time", stats.FrameTime);
+    TracyPlot("ImGui Atlas Memory", (int64)stats.AtlasMemory);
+    TracyPlot("ImGui Atlas Occupancy", stats.AtlasOccupancy);
+    TracyPlot("ImGui Dynamic Glyphs", (int64)stats.DynamicGlyphsCount);
+#endif
 }
 
 void ImGuiPlugin::OnPostRender(GPUContext* context, RenderContext& renderContext)
 {
     if (!IsReady() || !Enable || !EnableDrawing)
         return;
-    PROFILE_GPU_CPU("ImGui");
-
-    // Draw ImGui data into the output (via Render2D)
-    const ImDrawData* drawData = ImGui::GetDrawData();
-    if (!drawData)
-        return;
-    const Viewport viewport = renderContext.Task->GetOutputViewport();
-    Render2D::Begin(context, renderContext.Task->GetOutputView(), nullptr, viewport);
-    const ImVec2 displayPos = drawData->DisplayPos;
-    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
-    {
-        const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
-
-        // Convert vertex buffer
-        _vertices.Resize(cmdList->VtxBuffer.Size);
-        _uvs.Resize(cmdList->VtxBuffer.Size);
-        _colors.Resize(cmdList->VtxBuffer.Size);
-        for (int32 i = 0; i < cmdList->VtxBuffer.Size; i++)
+    ContextData* data = nullptr;
+    for (ContextData* e : _contexts)
+    {
+        if (e->Task.Get() == renderContext.Task)
         {
-            const ImDrawVert v = cmdList->VtxBuffer.Data[i];
-            _vertices.Get()[i] = Float2(v.pos.x, v.pos.y);
-            _uvs.Get()[i] = Float2(v.uv.x, v.uv.y);
-            _colors.Get()[i] = Color((float)((v.col >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_A_SHIFT) & 0xFF) / 255.0f);
-        }
-        Span<Float2> vertices(_vertices.Get(), _vertices.Count());
-        Span<Float2> uvs(_uvs.Get(), _uvs.Count());
-        Span<Color> colors(_colors.Get(), _colors.Count());
-        const uint16* indices = cmdList->IdxBuffer.Data;
-
-        // Submit draw commands
-        for (int cmdIndex = 0; cmdIndex < cmdList->CmdBuffer.Size; cmdIndex++)
-        {
-            const ImDrawCmd& cmd = cmdList->CmdBuffer[cmdIndex];
-            if (cmd.UserCallback)
-            {
-                cmd.UserCallback(cmdList, &cmd);
-            }
-            else
-            {
-                // Perform scissors clipping
-                const ImVec2 clipMin(cmd.ClipRect.x - displayPos.x, cmd.ClipRect.y - displayPos.y);
-                const ImVec2 clipMax(cmd.ClipRect.z - displayPos.x, cmd.ClipRect.w - displayPos.y);
-                if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
-                    continue;
-                Rectangle scissor(clipMin.x, clipMin.y, clipMax.x - clipMin.x, clipMax.y - clipMin.y);
-                Render2D::PushClip(scissor);
-
-                // Draw textured indexed triangles list
-                auto tex = (GPUTexture*)cmd.GetTexID();
-                Render2D::DrawTexturedTriangles(tex, Span<uint16>(indices + cmd.IdxOffset, cmd.ElemCount), vertices, uvs, colors);
-
-                Render2D::PopClip();
-            }
+            data = e;
+            break;
         }
     }
+    if (!data || data->Idle)
+        return;
+    PROFILE_GPU_CPU("ImGui");
+    _glyphCache->Flush(context, _fontAtlasTexture);
 
-    Render2D::End();
+    // Draw ImGui data into the output
+    const ImGuiDrawFrame* frame = data->DrawData.BeginRead();
+    if (frame && UpdateRate > 0.0f)
+        data->Renderer.DrawCached(context, renderContext, *frame);
+    else if (frame)
+        data->Renderer.Draw(context, renderContext, *frame);
+    data->DrawData.EndRead();
+    data->Drawn = frame != nullptr;
 }
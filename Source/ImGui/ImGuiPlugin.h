@@ -5,6 +5,79 @@
 #include "Engine/Scripting/Plugins/GamePlugin.h"
 #include "Engine/Core/Math/Vector2.h"
 #include "Engine/Core/Math/Color.h"
+#include "Engine/Scripting/ScriptingObjectReference.h"
+#include "ImGuiRenderer.h"
+#include "ImGuiGlyphCache.h"
+
+class SceneRenderTask;
+
+/// <summary>
+/// ImGui frame statistics (summed over all contexts).
+/// </summary>
+API_STRUCT(NoDefault) struct IMGUI_API ImGuiStats
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(ImGuiStats);
+
+    /// <summary>
+    /// The amount of vertices in the last frame draw data.
+    /// </summary>
+    API_FIELD() int32 VerticesCount = 0;
+
+    /// <summary>
+    /// The amount of indices in the last frame draw data.
+    /// </summary>
+    API_FIELD() int32 IndicesCount = 0;
+
+    /// <summary>
+    /// The amount of draw lists in the last frame draw data.
+    /// </summary>
+    API_FIELD() int32 DrawListsCount = 0;
+
+    /// <summary>
+    /// The amount of ImGui draw commands processed in the last drawn frame (before batching).
+    /// </summary>
+    API_FIELD() int32 DrawCommandsCount = 0;
+
+    /// <summary>
+    /// The amount of draw calls submitted in the last drawn frame (after batching).
+    /// </summary>
+    API_FIELD() int32 DrawCallsCount = 0;
+
+    /// <summary>
+    /// The amount of clipping rectangle changes in the last drawn frame.
+    /// </summary>
+    API_FIELD() int32 ClipPushesCount = 0;
+
+    /// <summary>
+    /// The amount of vertices uploaded (or converted) in the last drawn frame.
+    /// </summary>
+    API_FIELD() int32 UploadedVerticesCount = 0;
+
+    /// <summary>
+    /// The time (in milliseconds) spent on geometry conversion and upload in the last drawn frame.
+    /// </summary>
+    API_FIELD() float ConvertTime = 0.0f;
+
+    /// <summary>
+    /// The CPU time (in milliseconds) between NewFrame and Render of the last frame (includes interface building by game code).
+    /// </summary>
+    API_FIELD() float FrameTime = 0.0f;
+
+    /// <summary>
+    /// The font atlas texture GPU memory usage (in bytes).
+    /// </summary>
+    API_FIELD() uint64 AtlasMemory = 0;
+
+    /// <summary>
+    /// The ratio (0-1) of the font atlas texture area used by packed glyphs and custom rectangles (including the dynamic glyphs slots).
+    /// </summary>
+    API_FIELD() float AtlasOccupancy = 0.0f;
+
+    /// <summary>
+    /// The amount of glyphs rasterized on demand that are resident in the font atlas.
+    /// </summary>
+    API_FIELD() int32 DynamicGlyphsCount = 0;
+};
 
 /// <summary>
 /// Dear ImGui plugin that adds debug GUI interface to game viewport.
@@ -14,11 +87,47 @@ API_CLASS(Namespace="") class IMGUI_API ImGuiPlugin : public GamePlugin
     DECLARE_SCRIPTING_TYPE(ImGuiPlugin);
 
 private:
+    struct ContextData
+    {
+        int32 ID;
+        ImGuiContext* Context;
+        ScriptingObjectReference<SceneRenderTask> Task;
+        bool EnableInput;
+        bool CustomMousePosition = false;
+        Float2 MousePosition = Float2::Zero;
+        bool ActiveFrame = false;
+        bool Idle = false;
+        bool OldFontAtlas = false;
+        bool Drawn = false;
+        int32 GlyphsFrame = 0;
+        float UpdateTime = 0.0f;
+        float IdleTime = 0.0f;
+        double FrameStartTime = 0.0;
+        ImGuiStats Stats;
+        ImGuiRenderer Renderer;
+        ImGuiDrawDataRing DrawData;
+    };
+
     class GPUTexture* _fontAtlasTexture = nullptr;
-    Array<Float2> _vertices;
-    Array<Float2> _uvs;
-    Array<Color> _colors;
-    bool _activeFrame = false;
+    ImFontAtlas* _fontAtlas = nullptr;
+    ImGuiGlyphCache* _glyphCache = nullptr;
+    float _fontAtlasScale = 1.0f;
+    float _dpiScale = 1.0f;
+    bool _fontAtlasAlpha8 = false;
+
+    // Font atlas rebuilt in the background (swapped with the used one at the frame boundary once it's uploaded)
+    bool _fontAtlasRebuild = false;
+    int64 volatile _fontAtlasBuilding = 0;
+    ImFontAtlas* _newFontAtlas = nullptr;
+    class GPUTexture* _newFontAtlasTexture = nullptr;
+    ImGuiGlyphCache* _newGlyphCache = nullptr;
+    float _newFontAtlasScale = 1.0f;
+    Array<ImFontConfig> _newFonts;
+
+    // Texture of the previous font atlas (released once no context draws a frame built with it)
+    class GPUTexture* _oldFontAtlasTexture = nullptr;
+    Array<ContextData*> _contexts;
+    int32 _contextsCounter = 0;
 
 public:
     /// <summary>
@@ -41,12 +150,123 @@ public:
     /// </summary>
     API_FIELD() bool EnableDrawing = true;
 
+    /// <summary>
+    /// The rate (in updates per second) at which the interface is updated and redrawn. Use 0 to update it every frame. Between updates the input is queued and the last interface is composited from a cached texture. Game code should use ImGui API only when IsUpdating is true.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") float UpdateRate = 0.0f;
+
+    /// <summary>
+    /// Enables skipping ImGui frames (update, render and drawing) when interface is not used (no visible windows and no input) so plugin costs nearly nothing. Game code should use ImGui API only when IsUpdating is true.
+    /// </summary>
+    API_FIELD() bool EnableIdleMode = false;
+
+    /// <summary>
+    /// The rate (in updates per second) at which the frame is run while idle to detect windows opened by game code. Any input wakes up the interface immediately.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0.1f)") float IdleCheckRate = 4.0f;
+
+    /// <summary>
+    /// Enables caching of the text sizes measured by ImGui (io.ConfigTextSizeCache) between frames. Speeds up interfaces that display the same labels every frame (eg. large tables). Hits and misses are shown in the ImGui Metrics window.
+    /// </summary>
+    API_FIELD() bool EnableTextSizeCache = false;
+
+    /// <summary>
+    /// Enables caching of the line breaks of wrapped text (io.ConfigTextLayoutCache) between frames. Large wrapped texts (eg. logs) then only have their visible lines rendered and text appended to them only breaks the last lines again.
+    /// </summary>
+    API_FIELD() bool EnableTextLayoutCache = false;
+
+    /// <summary>
+    /// Checks if the frame of the current ImGui context is active and ImGui API can be used within the current game update. Always true during update unless UpdateRate or EnableIdleMode is used.
+    /// </summary>
+    API_PROPERTY() bool IsUpdating() const;
+
+    /// <summary>
+    /// Gets the statistics of the last ImGui frame (summed over all contexts).
+    /// </summary>
+    API_PROPERTY() ImGuiStats GetStats() const;
+
+public:
+    /// <summary>
+    /// Creates an additional ImGui context that draws the interface into the given render task output (eg. secondary camera, render to texture or split-screen view). All contexts share the same font atlas.
+    /// </summary>
+    /// <remarks>New context doesn't receive input by default (see SetContextInput). Use SetCurrentContext to submit windows to it.</remarks>
+    /// <param name="task">The render task to draw the interface into (after rendering).</param>
+    /// <returns>The context identifier or -1 if failed. The main context (drawn in the game viewport) uses identifier 0.</returns>
+    API_FUNCTION() int32 CreateContext(SceneRenderTask* task);
+
+    /// <summary>
+    /// Destroys the ImGui context created with CreateContext. Contexts are also destroyed automatically when their render task gets deleted.
+    /// </summary>
+    /// <param name="id">The context identifier.</param>
+    API_FUNCTION() void DestroyContext(int32 id);
+
+    /// <summary>
+    /// Gets the identifier of the current ImGui context used by the ImGui API.
+    /// </summary>
+    API_FUNCTION() int32 GetCurrentContext() const;
+
+    /// <summary>
+    /// Sets the current ImGui context used by the ImGui API. Main context (0) is restored as current at the beginning of each game update.
+    /// </summary>
+    /// <param name="id">The context identifier.</param>
+    API_FUNCTION() void SetCurrentContext(int32 id);
+
+    /// <summary>
+    /// Toggles input events routing to the given ImGui context. By default only the main context receives input.
+    /// </summary>
+    /// <param name="id">The context identifier.</param>
+    /// <param name="enable">True if context should receive input, otherwise false.</param>
+    API_FUNCTION() void SetContextInput(int32 id, bool enable);
+
+    /// <summary>
+    /// Sets the mouse position of the ImGui context (in pixels of its render task output). Use it for contexts drawn into textures displayed in the game (eg. map the cursor through the UI control or the surface showing the texture). By default, the main context uses the game viewport mouse position and other contexts use it relative to the output viewport of their render task.
+    /// </summary>
+    /// <param name="id">The context identifier.</param>
+    /// <param name="position">The mouse position. Used until the next call or ResetContextMousePosition.</param>
+    API_FUNCTION() void SetContextMousePosition(int32 id, const Float2& position);
+
+    /// <summary>
+    /// Restores the default mouse position of the ImGui context (see SetContextMousePosition).
+    /// </summary>
+    /// <param name="id">The context identifier.</param>
+    API_FUNCTION() void ResetContextMousePosition(int32 id);
+
+    /// <summary>
+    /// Rebuilds the font atlas in the background (done automatically when DPI scale changes). The current atlas is used until the new one is uploaded to GPU so the interface is drawn without hitches. Fonts keep their ImFont objects so pointers to them stay valid after the rebuild.
+    /// </summary>
+    API_FUNCTION() void RebuildFontAtlas();
+
+    /// <summary>
+    /// Adds the font to the font atlas at runtime. The font is available in the ImGui::GetIO().Fonts (after the already added fonts) once the atlas is rebuilt in the background (see RebuildFontAtlas).
+    /// </summary>
+    /// <param name="config">The font configuration (font data is copied). Font size is in pixels at DPI scale 1.</param>
+    void AddFont(const ImFontConfig& config);
+
+#if USE_EDITOR
+    /// <summary>
+    /// Bakes the font atlas (texture and glyphs) into the project asset (Content/ImGui/FontAtlas.flax) so fonts don't need to be rasterized at runtime. Done automatically when the baked atlas is missing or outdated.
+    /// </summary>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() bool BakeFontAtlas();
+#endif
+
 private:
     // [GamePlugin]
     void Initialize() override;
     void Deinitialize() override;
 
+    bool LoadFontAtlas();
+#if USE_EDITOR
+    bool SaveFontAtlas(const ImFontAtlas* atlas);
+#endif
+    class GPUTexture* UploadFontAtlas(ImFontAtlas* atlas) const;
+    void UpdateFontAtlas();
+    void BuildNewFontAtlas();
+    void ReleaseNewFontAtlas();
     bool IsReady();
+    ContextData* GetContext(int32 id) const;
+    void ReleaseContext(ContextData* context);
+    void UpdateContext(ContextData* context, float deltaTime);
     void OnUpdate();
     void OnLateUpdate();
     void OnPostRender(class GPUContext* context, struct RenderContext& renderContext);
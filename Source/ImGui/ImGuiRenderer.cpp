@@ -0,0 +1,825 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#include "ImGuiRenderer.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Matrix.h"
+#include "Engine/Core/Math/Rectangle.h"
+#include "Engine/Core/Math/Vector3.h"
+#include "Engine/Content/Content.h"
+#include "Engine/Engine/Globals.h"
+#include "Engine/Graphics/GPUBuffer.h"
+#include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/GPUPipelineState.h"
+#include "Engine/Graphics/RenderTask.h"
+#include "Engine/Graphics/Shaders/GPUShader.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
+#include "Engine/Profiler/Profiler.h"
+#include "Engine/Render2D/Render2D.h"
+#include "Engine/Threading/JobSystem.h"
+#include "ImGui/imgui_internal.h"
+#if !defined(IMGUI_ENABLE_SSE) && defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define IMGUI_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+
+// Shader asset compiled by the Editor from Source/Shaders/ImGui.shader (relative to the game project folder)
+#define IMGUI_SHADER_PATH TEXT("Plugins/ImGui/Content/Shaders/ImGui.flax")
+
+// Minimum amount of vertices in the frame to convert them on job system (small UI is faster to process on a single thread)
+#define IMGUI_JOBS_MIN_VERTICES 16384
+
+// Amount of vertices processed by a single conversion job (large draw lists are split into chunks)
+#define IMGUI_JOBS_CHUNK_VERTICES 8192
+
+PACK_STRUCT(struct ImGuiShaderData {
+    Matrix ViewProjection;
+    float FontSDF;
+    Float3 Dummy0;
+    });
+
+static_assert(sizeof(ImDrawVert) == sizeof(Float2) * 2 + sizeof(uint32), "ImGui shader input layout expects default ImDrawVert layout.");
+
+// Reorders packed ImGui color into RGBA8 byte order (no-op for the default packing)
+FORCE_INLINE static uint32 PackedColorToRGBA(ImU32 c)
+{
+    return ((c >> IM_COL32_R_SHIFT) & 0xFF) | (((c >> IM_COL32_G_SHIFT) & 0xFF) << 8) | (((c >> IM_COL32_B_SHIFT) & 0xFF) << 16) | (((c >> IM_COL32_A_SHIFT) & 0xFF) << 24);
+}
+
+// Converts ImGui vertices into separate position/UV/color streams as used by Render2D
+static void ConvertVertices(const ImDrawVert* src, int32 count, Float2* positions, Float2* uvs, Color* colors)
+{
+    int32 i = 0;
+#if defined(IMGUI_ENABLE_SSE)
+    // Process 4 vertices per iteration
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 colorScale = _mm_set1_ps(255.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const ImDrawVert* v = src + i;
+        for (int32 j = 0; j < 4; j++)
+        {
+            const __m128 posUv = _mm_loadu_ps(&v[j].pos.x);
+            _mm_storel_pi((__m64*)&positions[i + j], posUv);
+            _mm_storeh_pi((__m64*)&uvs[i + j], posUv);
+        }
+        const __m128i packed = _mm_set_epi32((int)PackedColorToRGBA(v[3].col), (int)PackedColorToRGBA(v[2].col), (int)PackedColorToRGBA(v[1].col), (int)PackedColorToRGBA(v[0].col));
+        const __m128i lo = _mm_unpacklo_epi8(packed, zero);
+        const __m128i hi = _mm_unpackhi_epi8(packed, zero);
+        _mm_storeu_ps(&colors[i + 0].R, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), colorScale));
+        _mm_storeu_ps(&colors[i + 1].R, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), colorScale));
+        _mm_storeu_ps(&colors[i + 2].R, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), colorScale));
+        _mm_storeu_ps(&colors[i + 3].R, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), colorScale));
+    }
+#elif defined(IMGUI_ENABLE_NEON)
+    const float32x4_t colorScale = vdupq_n_f32(255.0f);
+    for (; i < count; i++)
+    {
+        const ImDrawVert& v = src[i];
+        const float32x4_t posUv = vld1q_f32(&v.pos.x);
+        vst1_f32(&positions[i].X, vget_low_f32(posUv));
+        vst1_f32(&uvs[i].X, vget_high_f32(posUv));
+        const uint16x4_t color = vget_low_u16(vmovl_u8(vcreate_u8(PackedColorToRGBA(v.col))));
+        vst1q_f32(&colors[i].R, vdivq_f32(vcvtq_f32_u32(vmovl_u16(color)), colorScale));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        const ImDrawVert v = src[i];
+        positions[i] = Float2(v.pos.x, v.pos.y);
+        uvs[i] = Float2(v.uv.x, v.uv.y);
+        colors[i] = Color((float)((v.col >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f, (float)((v.col >> IM_COL32_A_SHIFT) & 0xFF) / 255.0f);
+    }
+}
+
+// Fast non-cryptographic hash of the memory (processes 8 bytes per step), used to detect draw lists changes
+static uint64 HashMemory(const void* data, uint64 size, uint64 hash)
+{
+    const byte* ptr = (const byte*)data;
+    const byte* end = ptr + size;
+    hash ^= size;
+    for (; ptr + sizeof(uint64) <= end; ptr += sizeof(uint64))
+    {
+        uint64 word;
+        Platform::MemoryCopy(&word, ptr, sizeof(uint64));
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    for (; ptr < end; ptr++)
+        hash = (hash ^ *ptr) * 0x100000001b3ull;
+    return hash;
+}
+
+static void ClearFrame(ImGuiDrawFrame& frame)
+{
+    frame.DrawData.Clear();
+    for (ImDrawList* list : frame.Lists)
+        IM_DELETE(list);
+    frame.Lists.clear();
+    frame.ListIds.clear();
+    frame.ListHashes.clear();
+}
+
+ImGuiDrawDataRing::~ImGuiDrawDataRing()
+{
+    _reading = -1;
+    Clear();
+}
+
+void ImGuiDrawDataRing::Push(const ImDrawData* drawData)
+{
+    PROFILE_CPU();
+
+    // Pick frame that is neither the latest one nor being read
+    int32 index = 0;
+    {
+        ScopeLock lock(_locker);
+        while (index == _latest || index == _reading)
+            index++;
+    }
+    ImGuiDrawFrame& frame = _frames[index];
+    frame.Version = ++_version;
+
+    // Copy draw lists (reuses previously allocated memory)
+    for (int32 i = frame.Lists.Size; i < drawData->CmdListsCount; i++)
+        frame.Lists.push_back(IM_NEW(ImDrawList)(nullptr));
+    frame.ListIds.resize(drawData->CmdListsCount);
+    frame.ListHashes.resize(drawData->CmdListsCount);
+    ImDrawData& dst = frame.DrawData;
+    dst.Clear();
+    dst.Valid = drawData->Valid;
+    dst.CmdListsCount = drawData->CmdListsCount;
+    dst.TotalIdxCount = drawData->TotalIdxCount;
+    dst.TotalVtxCount = drawData->TotalVtxCount;
+    dst.DisplayPos = drawData->DisplayPos;
+    dst.DisplaySize = drawData->DisplaySize;
+    dst.FramebufferScale = drawData->FramebufferScale;
+    dst.CmdLists.resize(drawData->CmdListsCount);
+    for (int32 i = 0; i < drawData->CmdListsCount; i++)
+    {
+        const ImDrawList* srcList = drawData->CmdLists[i];
+        ImDrawList* dstList = frame.Lists[i];
+        dstList->CmdBuffer.resize(srcList->CmdBuffer.Size);
+        dstList->IdxBuffer.resize(srcList->IdxBuffer.Size);
+        dstList->VtxBuffer.resize(srcList->VtxBuffer.Size);
+        Platform::MemoryCopy(dstList->CmdBuffer.Data, srcList->CmdBuffer.Data, srcList->CmdBuffer.size_in_bytes());
+        Platform::MemoryCopy(dstList->IdxBuffer.Data, srcList->IdxBuffer.Data, srcList->IdxBuffer.size_in_bytes());
+        Platform::MemoryCopy(dstList->VtxBuffer.Data, srcList->VtxBuffer.Data, srcList->VtxBuffer.size_in_bytes());
+        dstList->Flags = srcList->Flags;
+        dst.CmdLists[i] = dstList;
+
+        // Identify the draw list and its contents to reuse the geometry uploaded in the previous frames
+        frame.ListIds[i] = srcList->_OwnerName ? ImHashStr(srcList->_OwnerName) : 0;
+        uint64 hash = HashMemory(dstList->VtxBuffer.Data, dstList->VtxBuffer.size_in_bytes(), 0);
+        hash = HashMemory(dstList->IdxBuffer.Data, dstList->IdxBuffer.size_in_bytes(), hash);
+        hash = HashMemory(dstList->CmdBuffer.Data, dstList->CmdBuffer.size_in_bytes(), hash);
+        frame.ListHashes[i] = hash;
+    }
+
+    // Publish
+    ScopeLock lock(_locker);
+    _latest = index;
+}
+
+const ImGuiDrawFrame* ImGuiDrawDataRing::BeginRead()
+{
+    ScopeLock lock(_locker);
+    _reading = _latest;
+    return _reading != -1 ? &_frames[_reading] : nullptr;
+}
+
+void ImGuiDrawDataRing::EndRead()
+{
+    ScopeLock lock(_locker);
+    if (_clearReading && _reading != -1)
+        ClearFrame(_frames[_reading]);
+    _clearReading = false;
+    _reading = -1;
+}
+
+void ImGuiDrawDataRing::Clear()
+{
+    ScopeLock lock(_locker);
+    for (int32 i = 0; i < (int32)ARRAY_COUNT(_frames); i++)
+    {
+        // Frame being read stays valid until EndRead
+        if (i == _reading)
+            _clearReading = true;
+        else
+            ClearFrame(_frames[i]);
+    }
+    _latest = -1;
+}
+
+void ImGuiRenderer::Init()
+{
+    _shader = Content::LoadAsync<Shader>(Globals::ProjectFolder / IMGUI_SHADER_PATH);
+    if (!_shader)
+    {
+        LOG(Warning, "Missing ImGui shader. Using Render2D to draw ImGui.");
+        return;
+    }
+#if COMPILE_WITH_DEV_ENV
+    _shader.Get()->OnReloading.Bind<ImGuiRenderer, &ImGuiRenderer::OnShaderReloading>(this);
+#endif
+}
+
+void ImGuiRenderer::Dispose()
+{
+#if COMPILE_WITH_DEV_ENV
+    if (_shader)
+        _shader.Get()->OnReloading.Unbind<ImGuiRenderer, &ImGuiRenderer::OnShaderReloading>(this);
+#endif
+    _shader = nullptr;
+    SAFE_DELETE_GPU_RESOURCE(_psDefault);
+    SAFE_DELETE_GPU_RESOURCE(_psDefaultFont);
+    SAFE_DELETE_GPU_RESOURCE(_psOffscreen);
+    SAFE_DELETE_GPU_RESOURCE(_psOffscreenFont);
+    SAFE_DELETE_GPU_RESOURCE(_psComposite);
+    SAFE_DELETE_GPU_RESOURCE(_cachedTexture);
+    SAFE_DELETE_GPU_RESOURCE(_vb);
+    SAFE_DELETE_GPU_RESOURCE(_ib);
+    _indices.SetCapacity(0, false);
+    _cache.Clear();
+    ReleaseRender2D();
+}
+
+void ImGuiRenderer::Draw(GPUContext* context, RenderContext& renderContext, const ImGuiDrawFrame& frame)
+{
+    const ImDrawData* drawData = &frame.DrawData;
+    ResetStats();
+    if (_cachedTexture)
+    {
+        // Interface is no longer drawn at reduced rate
+        SAFE_DELETE_GPU_RESOURCE(_cachedTexture);
+    }
+    if (drawData->CmdListsCount == 0 || drawData->TotalVtxCount == 0)
+        return;
+    DrawTarget target;
+    target.Output = renderContext.Task->GetOutputView();
+    target.OutputViewport = renderContext.Task->GetOutputViewport();
+    target.State = _psDefault;
+    target.StateFont = _psDefaultFont;
+    if (CanDrawNative())
+    {
+        // Vertex colors are passed to GPU packed (4 bytes) so Render2D streams are no longer needed
+        if (_colors.Capacity() != 0)
+            ReleaseRender2D();
+        DrawNative(context, target, frame);
+    }
+    else if (!HasNative())
+    {
+        // Draw via Render2D when the shader is missing (while it's loading nothing is drawn as the font atlas is single-channel then)
+        DrawRender2D(context, target, frame);
+    }
+}
+
+void ImGuiRenderer::DrawCached(GPUContext* context, RenderContext& renderContext, const ImGuiDrawFrame& frame)
+{
+    // Compositing requires the shader (Render2D fallback draws directly to the output)
+    if (!CanDrawNative())
+    {
+        Draw(context, renderContext, frame);
+        return;
+    }
+    ResetStats();
+    const Viewport viewport = renderContext.Task->GetOutputViewport();
+    const int32 width = Math::Max((int32)viewport.Width, 1);
+    const int32 height = Math::Max((int32)viewport.Height, 1);
+
+    // Redraw the interface only when a new frame has been pushed (or output got resized)
+    if (!_cachedTexture)
+        _cachedTexture = GPUDevice::Instance->CreateTexture(TEXT("ImGui.Cached"));
+    if (_cachedTexture->Width() != width || _cachedTexture->Height() != height)
+    {
+        _cachedVersion = 0;
+        if (_cachedTexture->Init(GPUTextureDescription::New2D(width, height, PixelFormat::R8G8B8A8_UNorm, GPUTextureFlags::ShaderResource | GPUTextureFlags::RenderTarget)))
+        {
+            LOG(Error, "Failed to create ImGui offscreen texture.");
+            SAFE_DELETE_GPU_RESOURCE(_cachedTexture);
+            return;
+        }
+    }
+    if (_cachedVersion != frame.Version)
+    {
+        PROFILE_GPU_CPU_NAMED("Redraw");
+        _cachedVersion = frame.Version;
+        context->Clear(_cachedTexture->View(), Color::Transparent);
+        const ImDrawData* drawData = &frame.DrawData;
+        if (drawData->CmdListsCount != 0 && drawData->TotalVtxCount != 0)
+        {
+            if (_colors.Capacity() != 0)
+                ReleaseRender2D();
+            DrawTarget target;
+            target.Output = _cachedTexture->View();
+            target.OutputViewport = Viewport(0, 0, (float)width, (float)height);
+            target.State = _psOffscreen;
+            target.StateFont = _psOffscreenFont;
+            DrawNative(context, target, frame);
+        }
+    }
+
+    // Composite the interface over the output (texture contains premultiplied colors)
+    context->SetRenderTarget(renderContext.Task->GetOutputView());
+    context->SetViewportAndScissors(viewport);
+    context->SetState(_psComposite);
+    context->BindSR(0, _cachedTexture->View());
+    context->DrawFullscreenTriangle();
+    context->ResetSR();
+    context->ResetRenderTarget();
+}
+
+bool ImGuiRenderer::HasNative() const
+{
+    return _shader && !_shader->LastLoadFailed();
+}
+
+bool ImGuiRenderer::CanDrawNative()
+{
+    if (_psDefault && _psDefault->IsValid() && _psDefaultFont->IsValid() && _psOffscreen->IsValid() && _psOffscreenFont->IsValid() && _psComposite->IsValid())
+        return true;
+    if (!_shader || !_shader->IsLoaded())
+        return false;
+    const auto shader = _shader->GetShader();
+    const auto cb = shader->GetCB(0);
+    if (!cb || cb->GetSize() != sizeof(ImGuiShaderData))
+    {
+        LOG(Error, "Invalid ImGui shader constant buffer size.");
+        _shader = nullptr;
+        return false;
+    }
+
+    // Create pipeline states
+    if (!_psDefault)
+    {
+        _psDefault = GPUDevice::Instance->CreatePipelineState();
+        _psDefaultFont = GPUDevice::Instance->CreatePipelineState();
+        _psOffscreen = GPUDevice::Instance->CreatePipelineState();
+        _psOffscreenFont = GPUDevice::Instance->CreatePipelineState();
+        _psComposite = GPUDevice::Instance->CreatePipelineState();
+    }
+    GPUPipelineState::Description psDesc = GPUPipelineState::Description::DefaultNoDepth;
+    psDesc.CullMode = CullMode::TwoSided;
+    psDesc.BlendMode = BlendingMode::AlphaBlend;
+#ifdef IMGUI_USE_BGRA_PACKED_COLOR
+    psDesc.VS = shader->GetVS("VS", 1);
+#else
+    psDesc.VS = shader->GetVS("VS", 0);
+#endif
+    psDesc.PS = shader->GetPS("PS");
+    bool failed = _psDefault->Init(psDesc);
+    psDesc.PS = shader->GetPS("PS_Font");
+    failed |= _psDefaultFont->Init(psDesc);
+    {
+        // Offscreen texture accumulates premultiplied colors and coverage in alpha
+        psDesc.BlendMode.SrcBlendAlpha = BlendingMode::Blend::One;
+        psDesc.BlendMode.DestBlendAlpha = BlendingMode::Blend::InvSrcAlpha;
+        psDesc.PS = shader->GetPS("PS");
+        failed |= _psOffscreen->Init(psDesc);
+        psDesc.PS = shader->GetPS("PS_Font");
+        failed |= _psOffscreenFont->Init(psDesc);
+    }
+    {
+        psDesc = GPUPipelineState::Description::DefaultFullscreenTriangle;
+        psDesc.BlendMode = BlendingMode::AlphaBlend;
+        psDesc.BlendMode.SrcBlend = BlendingMode::Blend::One;
+        psDesc.BlendMode.DestBlend = BlendingMode::Blend::InvSrcAlpha;
+        psDesc.PS = shader->GetPS("PS_Composite");
+        failed |= _psComposite->Init(psDesc);
+    }
+    if (failed)
+    {
+        LOG(Error, "Failed to create ImGui pipeline state.");
+        _shader = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ImGuiRenderer::DrawNative(GPUContext* context, const DrawTarget& target, const ImGuiDrawFrame& frame)
+{
+    const ImDrawData* drawData = &frame.DrawData;
+    if (EnsureBuffers(drawData->TotalVtxCount, drawData->TotalIdxCount))
+        return;
+
+    // Upload geometry of all changed draw lists (ImDrawVert/ImDrawIdx are consumed by the shader as-is)
+    // When all vertices can be addressed by the index format, indices are rebased to the global vertex buffer so commands from different draw lists can be merged
+    const double convertStartTime = Platform::GetTimeSeconds();
+    _rebaseIndices = sizeof(ImDrawIdx) == 4 || drawData->TotalVtxCount <= MAX_uint16 + 1;
+    UpdateCache(frame, true);
+    _indices.Resize(drawData->TotalIdxCount, false);
+    RunJobs(drawData, true);
+    {
+        PROFILE_CPU_NAMED("Upload");
+        int32 vertexOffset = 0, indexOffset = 0;
+        for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
+        {
+            const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
+            if (_changed[cmdListIndex] && cmdList->VtxBuffer.Size != 0)
+            {
+                const ImDrawIdx* indices = _rebaseIndices && vertexOffset != 0 ? _indices.Get() + indexOffset : cmdList->IdxBuffer.Data;
+                context->UpdateBuffer(_vb, cmdList->VtxBuffer.Data, cmdList->VtxBuffer.size_in_bytes(), vertexOffset * sizeof(ImDrawVert));
+                context->UpdateBuffer(_ib, indices, cmdList->IdxBuffer.size_in_bytes(), indexOffset * sizeof(ImDrawIdx));
+            }
+            vertexOffset += cmdList->VtxBuffer.Size;
+            indexOffset += cmdList->IdxBuffer.Size;
+        }
+    }
+    ConvertTime = (float)((Platform::GetTimeSeconds() - convertStartTime) * 1000.0);
+    SetupState(context, target, drawData);
+
+    // Submit draw commands (adjacent commands with the same texture and clipping are merged into a single draw call)
+    const Viewport& viewport = target.OutputViewport;
+    const ImVec2 displayPos = drawData->DisplayPos;
+    DrawBatch batch;
+    batch.IndicesCount = 0;
+    int32 vertexOffset = 0;
+    int32 indexOffset = 0;
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
+    {
+        const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
+        for (int cmdIndex = 0; cmdIndex < cmdList->CmdBuffer.Size; cmdIndex++)
+        {
+            const ImDrawCmd& cmd = cmdList->CmdBuffer[cmdIndex];
+            if (cmd.UserCallback)
+            {
+                FlushBatch(context, target, batch);
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState)
+                    SetupState(context, target, drawData);
+                else
+                    cmd.UserCallback(cmdList, &cmd);
+                _scissor = Rectangle::Empty;
+                _state = nullptr;
+                continue;
+            }
+            DrawCommandsCount++;
+
+            // Perform scissors clipping (in output pixels), skip commands outside the viewport
+            const ImVec2 clipMin(Math::Max(cmd.ClipRect.x - displayPos.x, 0.0f), Math::Max(cmd.ClipRect.y - displayPos.y, 0.0f));
+            const ImVec2 clipMax(Math::Min(cmd.ClipRect.z - displayPos.x, viewport.Width), Math::Min(cmd.ClipRect.w - displayPos.y, viewport.Height));
+            if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y || cmd.ElemCount == 0)
+                continue;
+            const Rectangle scissor(viewport.X + clipMin.x, viewport.Y + clipMin.y, clipMax.x - clipMin.x, clipMax.y - clipMin.y);
+
+            // Merge with the previous command if possible
+            GPUTexture* texture = (GPUTexture*)cmd.GetTexID();
+            const int32 startIndex = indexOffset + (int32)cmd.IdxOffset;
+            const int32 baseVertex = (_rebaseIndices ? 0 : vertexOffset) + (int32)cmd.VtxOffset;
+            if (batch.IndicesCount != 0 && batch.Texture == texture && batch.Scissor == scissor && batch.BaseVertex == baseVertex && batch.StartIndex + (int32)batch.IndicesCount == startIndex)
+            {
+                batch.IndicesCount += cmd.ElemCount;
+                continue;
+            }
+            FlushBatch(context, target, batch);
+            batch.Texture = texture;
+            batch.Scissor = scissor;
+            batch.StartIndex = startIndex;
+            batch.IndicesCount = cmd.ElemCount;
+            batch.BaseVertex = baseVertex;
+        }
+        vertexOffset += cmdList->VtxBuffer.Size;
+        indexOffset += cmdList->IdxBuffer.Size;
+    }
+    FlushBatch(context, target, batch);
+
+    context->ResetSR();
+    context->ResetRenderTarget();
+}
+
+void ImGuiRenderer::SetupState(GPUContext* context, const DrawTarget& target, const ImDrawData* drawData)
+{
+    const ImVec2 displayPos = drawData->DisplayPos;
+    const ImVec2 displaySize = drawData->DisplaySize;
+    ImGuiShaderData data;
+    Matrix projection;
+    Matrix::OrthoOffCenter(displayPos.x, displayPos.x + displaySize.x, displayPos.y + displaySize.y, displayPos.y, 0.0f, 1.0f, projection);
+    Matrix::Transpose(projection, data.ViewProjection);
+    data.FontSDF = FontSDF ? 1.0f : 0.0f;
+    data.Dummy0 = Float3::Zero;
+    const auto cb = _shader->GetShader()->GetCB(0);
+    context->UpdateCB(cb, &data);
+    context->BindCB(0, cb);
+    context->SetRenderTarget(target.Output);
+    context->SetViewportAndScissors(target.OutputViewport);
+    _scissor = Rectangle::Empty;
+    _state = target.State;
+    context->SetState(target.State);
+    context->BindVB(ToSpan(&_vb, 1));
+    context->BindIB(_ib);
+}
+
+void ImGuiRenderer::FlushBatch(GPUContext* context, const DrawTarget& target, DrawBatch& batch)
+{
+    if (batch.IndicesCount == 0)
+        return;
+    DrawCallsCount++;
+
+    // Single-channel textures (eg. font atlas) store coverage in red channel
+    GPUPipelineState* state = batch.Texture && batch.Texture->Format() == PixelFormat::R8_UNorm ? target.StateFont : target.State;
+    if (state != _state)
+    {
+        _state = state;
+        context->SetState(state);
+    }
+    if (batch.Scissor != _scissor)
+    {
+        ClipPushesCount++;
+        _scissor = batch.Scissor;
+        context->SetScissor(batch.Scissor);
+    }
+    context->BindSR(0, batch.Texture);
+    context->DrawIndexed(batch.IndicesCount, batch.BaseVertex, batch.StartIndex);
+    batch.IndicesCount = 0;
+}
+
+bool ImGuiRenderer::EnsureBuffers(int32 verticesCount, int32 indicesCount)
+{
+    if (!_vb)
+    {
+        _vb = GPUDevice::Instance->CreateBuffer(TEXT("ImGui.VB"));
+        _ib = GPUDevice::Instance->CreateBuffer(TEXT("ImGui.IB"));
+    }
+
+    // Grow buffers (previously uploaded geometry is lost)
+    // Buffers use default usage so partial updates keep the rest of the contents intact
+    if (!_vb->IsAllocated() || (int32)_vb->GetElementsCount() < verticesCount)
+    {
+        _cache.Clear();
+        if (_vb->Init(GPUBufferDescription::Buffer(Math::Max(verticesCount + verticesCount / 2, 4096) * sizeof(ImDrawVert), GPUBufferFlags::VertexBuffer, PixelFormat::Unknown, nullptr, sizeof(ImDrawVert), GPUResourceUsage::Default)))
+        {
+            LOG(Error, "Failed to create ImGui vertex buffer.");
+            return true;
+        }
+    }
+    if (!_ib->IsAllocated() || (int32)_ib->GetElementsCount() < indicesCount)
+    {
+        _cache.Clear();
+        if (_ib->Init(GPUBufferDescription::Buffer(Math::Max(indicesCount + indicesCount / 2, 8192) * sizeof(ImDrawIdx), GPUBufferFlags::IndexBuffer, PixelFormat::Unknown, nullptr, sizeof(ImDrawIdx), GPUResourceUsage::Default)))
+        {
+            LOG(Error, "Failed to create ImGui index buffer.");
+            return true;
+        }
+    }
+    return false;
+}
+
+void ImGuiRenderer::DrawRender2D(GPUContext* context, const DrawTarget& target, const ImGuiDrawFrame& frame)
+{
+    const ImDrawData* drawData = &frame.DrawData;
+    // Draw ImGui data into the output (via Render2D)
+    const Viewport& viewport = target.OutputViewport;
+    Render2D::Begin(context, target.Output, nullptr, viewport);
+    const ImVec2 displayPos = drawData->DisplayPos;
+
+    // Convert vertex buffers of all changed draw lists
+    const double convertStartTime = Platform::GetTimeSeconds();
+    _vertices.Resize(drawData->TotalVtxCount);
+    _uvs.Resize(drawData->TotalVtxCount);
+    _colors.Resize(drawData->TotalVtxCount);
+    UpdateCache(frame, false);
+    RunJobs(drawData, false);
+    ConvertTime = (float)((Platform::GetTimeSeconds() - convertStartTime) * 1000.0);
+
+    int32 vertexOffset = 0;
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
+    {
+        const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
+        const ImDrawIdx* indices = cmdList->IdxBuffer.Data;
+
+        // Submit draw commands (adjacent commands with the same texture and clipping are merged into a single draw call)
+        for (int cmdIndex = 0; cmdIndex < cmdList->CmdBuffer.Size;)
+        {
+            const ImDrawCmd& cmd = cmdList->CmdBuffer[cmdIndex++];
+            if (cmd.UserCallback)
+            {
+                if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                    cmd.UserCallback(cmdList, &cmd);
+                continue;
+            }
+            DrawCommandsCount++;
+
+            // Perform scissors clipping, skip commands outside the viewport
+            const ImVec2 clipMin(Math::Max(cmd.ClipRect.x - displayPos.x, 0.0f), Math::Max(cmd.ClipRect.y - displayPos.y, 0.0f));
+            const ImVec2 clipMax(Math::Min(cmd.ClipRect.z - displayPos.x, viewport.Width), Math::Min(cmd.ClipRect.w - displayPos.y, viewport.Height));
+            if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y || cmd.ElemCount == 0)
+                continue;
+            Rectangle scissor(clipMin.x, clipMin.y, clipMax.x - clipMin.x, clipMax.y - clipMin.y);
+
+            // Merge following commands
+            auto tex = (GPUTexture*)cmd.GetTexID();
+            uint32 elemCount = cmd.ElemCount;
+            while (cmdIndex < cmdList->CmdBuffer.Size)
+            {
+                const ImDrawCmd& next = cmdList->CmdBuffer[cmdIndex];
+                if (next.UserCallback || next.GetTexID() != cmd.GetTexID() || next.VtxOffset != cmd.VtxOffset || next.IdxOffset != cmd.IdxOffset + elemCount || Platform::MemoryCompare(&next.ClipRect, &cmd.ClipRect, sizeof(ImVec4)) != 0)
+                    break;
+                DrawCommandsCount++;
+                elemCount += next.ElemCount;
+                cmdIndex++;
+            }
+
+            // Draw textured indexed triangles list
+            ClipPushesCount++;
+            Render2D::PushClip(scissor);
+            DrawRender2DTriangles(tex, indices + cmd.IdxOffset, (int32)elemCount, vertexOffset + (int32)cmd.VtxOffset, cmdList->VtxBuffer.Size - (int32)cmd.VtxOffset);
+            Render2D::PopClip();
+        }
+        vertexOffset += cmdList->VtxBuffer.Size;
+    }
+
+    Render2D::End();
+}
+
+void ImGuiRenderer::DrawRender2DTriangles(GPUTexture* texture, const ImDrawIdx* indices, int32 indicesCount, int32 vertexOffset, int32 verticesCount)
+{
+    if (sizeof(ImDrawIdx) == 2)
+    {
+        DrawCallsCount++;
+        Render2D::DrawTexturedTriangles(texture, Span<uint16>((const uint16*)indices, indicesCount), Span<Float2>(_vertices.Get() + vertexOffset, verticesCount), Span<Float2>(_uvs.Get() + vertexOffset, verticesCount), Span<Color>(_colors.Get() + vertexOffset, verticesCount));
+        return;
+    }
+
+    // Render2D uses 16-bit indices so split triangles into chunks that address up to 64k vertices and remap indices relative to the lowest vertex of the chunk
+    for (int32 start = 0; start < indicesCount;)
+    {
+        uint32 minIndex = (uint32)indices[start], maxIndex = (uint32)indices[start];
+        int32 end = start;
+        for (; end + 2 < indicesCount; end += 3)
+        {
+            const uint32 triangleMin = (uint32)Math::Min(indices[end], Math::Min(indices[end + 1], indices[end + 2]));
+            const uint32 triangleMax = (uint32)Math::Max(indices[end], Math::Max(indices[end + 1], indices[end + 2]));
+            if (end != start && Math::Max(maxIndex, triangleMax) - Math::Min(minIndex, triangleMin) > MAX_uint16)
+                break;
+            minIndex = Math::Min(minIndex, triangleMin);
+            maxIndex = Math::Max(maxIndex, triangleMax);
+        }
+        if (end == start)
+            break;
+        DrawCallsCount++;
+        const int32 chunkVertexOffset = vertexOffset + (int32)minIndex;
+        if (maxIndex - minIndex > MAX_uint16)
+        {
+            // Single triangle that spans over too many vertices
+            Float2 vertices[3], uvs[3];
+            Color colors[3];
+            for (int32 i = 0; i < 3; i++)
+            {
+                const int32 vertexIndex = vertexOffset + (int32)indices[start + i];
+                vertices[i] = _vertices[vertexIndex];
+                uvs[i] = _uvs[vertexIndex];
+                colors[i] = _colors[vertexIndex];
+            }
+            Render2D::DrawTexturedTriangles(texture, Span<Float2>(vertices, 3), Span<Float2>(uvs, 3), Span<Color>(colors, 3));
+        }
+        else
+        {
+            const int32 chunkVerticesCount = (int32)(maxIndex - minIndex) + 1;
+            _indices16.Resize(end - start, false);
+            for (int32 i = start; i < end; i++)
+                _indices16.Get()[i - start] = (uint16)((uint32)indices[i] - minIndex);
+            Render2D::DrawTexturedTriangles(texture, Span<uint16>(_indices16.Get(), _indices16.Count()), Span<Float2>(_vertices.Get() + chunkVertexOffset, chunkVerticesCount), Span<Float2>(_uvs.Get() + chunkVertexOffset, chunkVerticesCount), Span<Color>(_colors.Get() + chunkVertexOffset, chunkVerticesCount));
+        }
+        start = end;
+    }
+}
+
+void ImGuiRenderer::ResetStats()
+{
+    DrawCommandsCount = 0;
+    DrawCallsCount = 0;
+    ClipPushesCount = 0;
+    UploadedVerticesCount = 0;
+    ConvertTime = 0.0f;
+}
+
+void ImGuiRenderer::ReleaseRender2D()
+{
+    _vertices.SetCapacity(0, false);
+    _uvs.SetCapacity(0, false);
+    _colors.SetCapacity(0, false);
+    _indices16.SetCapacity(0, false);
+}
+
+void ImGuiRenderer::UpdateCache(const ImGuiDrawFrame& frame, bool native)
+{
+    // Geometry of the draw list can be reused if it has the same contents and location as in the previous frame
+    const bool rebased = native && _rebaseIndices;
+    if (_cacheNative != native || _cacheRebased != rebased)
+    {
+        _cacheNative = native;
+        _cacheRebased = rebased;
+        _cache.Clear();
+    }
+    _cacheFrame++;
+    const ImDrawData* drawData = &frame.DrawData;
+    _changed.Resize(drawData->CmdListsCount);
+    UploadedVerticesCount = 0;
+    int32 vertexOffset = 0, indexOffset = 0;
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
+    {
+        const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
+        CachedList& cached = _cache[frame.ListIds[cmdListIndex]];
+        bool changed = true;
+        if (cached.Frame != _cacheFrame)
+        {
+            // Draw lists with duplicated identifier within a frame are always treated as changed
+            changed = cached.Frame + 1 != _cacheFrame || cached.Hash != frame.ListHashes[cmdListIndex] || cached.VertexOffset != vertexOffset || cached.IndexOffset != indexOffset;
+            cached.Hash = frame.ListHashes[cmdListIndex];
+            cached.VertexOffset = vertexOffset;
+            cached.IndexOffset = indexOffset;
+            cached.Frame = _cacheFrame;
+        }
+        _changed[cmdListIndex] = changed;
+        if (changed)
+            UploadedVerticesCount += cmdList->VtxBuffer.Size;
+        vertexOffset += cmdList->VtxBuffer.Size;
+        indexOffset += cmdList->IdxBuffer.Size;
+    }
+
+    // Remove draw lists that are no longer used
+    for (auto i = _cache.Begin(); i.IsNotEnd(); ++i)
+    {
+        if (i->Value.Frame != _cacheFrame)
+            _cache.Remove(i);
+    }
+}
+
+void ImGuiRenderer::RunJobs(const ImDrawData* drawData, bool native)
+{
+    PROFILE_CPU();
+
+    // Split work into jobs for the changed draw lists (native path rebases indices of whole draw lists, Render2D path converts chunks of vertices)
+    _jobs.Clear();
+    _jobsNative = native;
+    int32 vertexOffset = 0, indexOffset = 0;
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++)
+    {
+        const ImDrawList* cmdList = drawData->CmdLists[cmdListIndex];
+        if (!_changed[cmdListIndex] || (native && !(_rebaseIndices && vertexOffset != 0)))
+        {
+            vertexOffset += cmdList->VtxBuffer.Size;
+            indexOffset += cmdList->IdxBuffer.Size;
+            continue;
+        }
+        const int32 chunkSize = native ? MAX_int32 : IMGUI_JOBS_CHUNK_VERTICES;
+        for (int32 start = 0; start < cmdList->VtxBuffer.Size; start += chunkSize)
+        {
+            auto& job = _jobs.AddOne();
+            job.List = cmdList;
+            job.VertexStart = start;
+            job.VertexCount = Math::Min(cmdList->VtxBuffer.Size - start, chunkSize);
+            job.VertexOffset = vertexOffset + start;
+            job.IndexOffset = start == 0 ? indexOffset : -1;
+        }
+        vertexOffset += cmdList->VtxBuffer.Size;
+        indexOffset += cmdList->IdxBuffer.Size;
+    }
+
+    // Run jobs
+    if (_jobs.Count() > 1 && UploadedVerticesCount >= IMGUI_JOBS_MIN_VERTICES)
+    {
+        Function<void(int32)> func;
+        func.Bind<ImGuiRenderer, &ImGuiRenderer::Job>(this);
+        JobSystem::Wait(JobSystem::Dispatch(func, _jobs.Count()));
+    }
+    else
+    {
+        for (int32 i = 0; i < _jobs.Count(); i++)
+            Job(i);
+    }
+}
+
+void ImGuiRenderer::Job(int32 index)
+{
+    const auto& job = _jobs[index];
+    const ImDrawVert* src = job.List->VtxBuffer.Data + job.VertexStart;
+    if (_jobsNative)
+    {
+        // Rebase indices to the global vertex buffer
+        ImDrawIdx* dstIndices = _indices.Get() + job.IndexOffset;
+        const ImDrawIdx* srcIndices = job.List->IdxBuffer.Data;
+        const int32 indicesCount = job.List->IdxBuffer.Size;
+        const ImDrawIdx baseVertex = (ImDrawIdx)job.VertexOffset;
+        for (int32 i = 0; i < indicesCount; i++)
+            dstIndices[i] = srcIndices[i] + baseVertex;
+    }
+    else
+    {
+        ConvertVertices(src, job.VertexCount, _vertices.Get() + job.VertexOffset, _uvs.Get() + job.VertexOffset, _colors.Get() + job.VertexOffset);
+    }
+}
+
+#if COMPILE_WITH_DEV_ENV
+
+void ImGuiRenderer::OnShaderReloading(Asset* obj)
+{
+    if (_psDefault)
+    {
+        _psDefault->ReleaseGPU();
+        _psDefaultFont->ReleaseGPU();
+        _psOffscreen->ReleaseGPU();
+        _psOffscreenFont->ReleaseGPU();
+        _psComposite->ReleaseGPU();
+    }
+}
+
+#endif
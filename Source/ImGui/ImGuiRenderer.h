@@ -0,0 +1,238 @@
+﻿// Copyright (c) Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Math/Color.h"
+#include "Engine/Core/Math/Rectangle.h"
+#include "Engine/Core/Math/Viewport.h"
+#include "Engine/Content/AssetReference.h"
+#include "Engine/Content/Assets/Shader.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "ImGui/imgui.h"
+
+class GPUBuffer;
+class GPUContext;
+class GPUTexture;
+class GPUPipelineState;
+class GPUTextureView;
+struct RenderContext;
+
+/// <summary>
+/// Copy of the ImGui frame draw data with additional per-draw list information used by the renderer.
+/// </summary>
+struct ImGuiDrawFrame
+{
+    // The frame version (increased for every pushed frame).
+    uint64 Version = 0;
+
+    // The draw data (points to the Lists).
+    ImDrawData DrawData;
+
+    // The draw lists owned by the frame (memory is reused between frames).
+    ImVector<ImDrawList*> Lists;
+
+    // The identifier of each draw list owner (hash of the window name).
+    ImVector<ImGuiID> ListIds;
+
+    // The hash of each draw list contents (vertices, indices and commands including clipping and textures).
+    ImVector<uint64> ListHashes;
+};
+
+/// <summary>
+/// Ring of ImGui draw data copies that allows rendering the last UI frame while the next one is being built (eg. on a different thread).
+/// </summary>
+class ImGuiDrawDataRing
+{
+private:
+    CriticalSection _locker;
+    ImGuiDrawFrame _frames[3];
+    int32 _latest = -1;
+    int32 _reading = -1;
+    bool _clearReading = false;
+    uint64 _version = 0;
+
+public:
+    ~ImGuiDrawDataRing();
+
+public:
+    /// <summary>
+    /// Copies the draw data (eg. ImGui::GetDrawData() after ImGui::Render) and publishes it as the latest frame to draw.
+    /// </summary>
+    /// <param name="drawData">The draw data to copy.</param>
+    void Push(const ImDrawData* drawData);
+
+    /// <summary>
+    /// Begins reading the latest frame. Must be paired with EndRead. Copied data stays valid until then.
+    /// </summary>
+    /// <returns>The latest frame or null if none has been pushed.</returns>
+    const ImGuiDrawFrame* BeginRead();
+
+    /// <summary>
+    /// Ends reading the frame returned by BeginRead.
+    /// </summary>
+    void EndRead();
+
+    /// <summary>
+    /// Clears the copied draw data and releases the memory. The frame being read is released by EndRead.
+    /// </summary>
+    void Clear();
+};
+
+/// <summary>
+/// Dear ImGui renderer backend that draws ImDrawData directly with a dedicated shader and persistent GPU buffers. Falls back to Render2D when shader is not yet available.
+/// </summary>
+class ImGuiRenderer
+{
+private:
+    struct ConvertJob
+    {
+        const ImDrawList* List;
+        int32 VertexStart;
+        int32 VertexCount;
+        int32 VertexOffset;
+        int32 IndexOffset;
+    };
+
+    struct CachedList
+    {
+        uint64 Hash = 0;
+        int32 VertexOffset = -1;
+        int32 IndexOffset = -1;
+        uint64 Frame = 0;
+    };
+
+    struct DrawTarget
+    {
+        GPUTextureView* Output;
+        Viewport OutputViewport;
+        GPUPipelineState* State;
+        GPUPipelineState* StateFont;
+    };
+
+    struct DrawBatch
+    {
+        GPUTexture* Texture;
+        Rectangle Scissor;
+        int32 StartIndex;
+        uint32 IndicesCount;
+        int32 BaseVertex;
+    };
+
+    AssetReference<Shader> _shader;
+    GPUPipelineState* _psDefault = nullptr;
+    GPUPipelineState* _psDefaultFont = nullptr;
+    GPUPipelineState* _psOffscreen = nullptr;
+    GPUPipelineState* _psOffscreenFont = nullptr;
+    GPUPipelineState* _psComposite = nullptr;
+    GPUBuffer* _vb = nullptr;
+    GPUBuffer* _ib = nullptr;
+    Array<ImDrawIdx> _indices;
+
+    // Draw lists geometry uploaded (or converted) in the previous frames
+    Dictionary<ImGuiID, CachedList> _cache;
+    Array<bool> _changed;
+    uint64 _cacheFrame = 0;
+    bool _cacheNative = false;
+    bool _cacheRebased = false;
+
+    // Offscreen texture with the interface drawn at reduced rate
+    GPUTexture* _cachedTexture = nullptr;
+    uint64 _cachedVersion = 0;
+
+    // Render2D fallback data
+    Array<Float2> _vertices;
+    Array<Float2> _uvs;
+    Array<Color> _colors;
+    Array<uint16> _indices16;
+
+    // Geometry conversion jobs
+    Array<ConvertJob> _jobs;
+    bool _jobsNative = false;
+    bool _rebaseIndices = false;
+    Rectangle _scissor;
+    GPUPipelineState* _state = nullptr;
+
+public:
+    /// <summary>
+    /// Enables decoding of single-channel textures (eg. font atlas) as signed distance fields (font atlas built with ImFontAtlasFlags_SignedDistanceField). Supported only by the native path.
+    /// </summary>
+    bool FontSDF = false;
+
+    /// <summary>
+    /// The amount of ImGui draw commands processed in the last drawn frame (before batching).
+    /// </summary>
+    int32 DrawCommandsCount = 0;
+
+    /// <summary>
+    /// The amount of draw calls submitted in the last drawn frame (after batching).
+    /// </summary>
+    int32 DrawCallsCount = 0;
+
+    /// <summary>
+    /// The amount of clipping rectangle changes in the last drawn frame (scissors set or Render2D clip pushes).
+    /// </summary>
+    int32 ClipPushesCount = 0;
+
+    /// <summary>
+    /// The amount of vertices uploaded (or converted) in the last drawn frame. Draw lists that did not change since the previous frame are reused.
+    /// </summary>
+    int32 UploadedVerticesCount = 0;
+
+    /// <summary>
+    /// The time (in milliseconds) spent on geometry conversion and upload in the last drawn frame.
+    /// </summary>
+    float ConvertTime = 0.0f;
+
+public:
+    /// <summary>
+    /// Initializes the renderer (starts the shader loading).
+    /// </summary>
+    void Init();
+
+    /// <summary>
+    /// Releases the renderer resources.
+    /// </summary>
+    void Dispose();
+
+    /// <summary>
+    /// Checks if the ImGui data is going to be drawn directly (without Render2D fallback) without waiting for the shader to be loaded. Only the native path supports single-channel (R8) textures such as font atlas.
+    /// </summary>
+    /// <returns>True if the shader is available (loaded or still loading), otherwise false.</returns>
+    bool HasNative() const;
+
+    /// <summary>
+    /// Draws the ImGui data into the render task output.
+    /// </summary>
+    /// <param name="context">The GPU context.</param>
+    /// <param name="renderContext">The rendering context (of the task that outputs the UI).</param>
+    /// <param name="frame">The ImGui frame data.</param>
+    void Draw(GPUContext* context, RenderContext& renderContext, const ImGuiDrawFrame& frame);
+
+    /// <summary>
+    /// Draws the ImGui data into the offscreen texture (only if the frame changed since the last call) and composites it over the render task output.
+    /// </summary>
+    /// <param name="context">The GPU context.</param>
+    /// <param name="renderContext">The rendering context (of the task that outputs the UI).</param>
+    /// <param name="frame">The ImGui frame data.</param>
+    void DrawCached(GPUContext* context, RenderContext& renderContext, const ImGuiDrawFrame& frame);
+
+private:
+    bool CanDrawNative();
+    void DrawNative(GPUContext* context, const DrawTarget& target, const ImGuiDrawFrame& frame);
+    bool EnsureBuffers(int32 verticesCount, int32 indicesCount);
+    void SetupState(GPUContext* context, const DrawTarget& target, const ImDrawData* drawData);
+    void FlushBatch(GPUContext* context, const DrawTarget& target, DrawBatch& batch);
+    void DrawRender2D(GPUContext* context, const DrawTarget& target, const ImGuiDrawFrame& frame);
+    void DrawRender2DTriangles(GPUTexture* texture, const ImDrawIdx* indices, int32 indicesCount, int32 vertexOffset, int32 verticesCount);
+    void UpdateCache(const ImGuiDrawFrame& frame, bool native);
+    void ResetStats();
+    void ReleaseRender2D();
+    void RunJobs(const ImDrawData* drawData, bool native);
+    void Job(int32 index);
+#if COMPILE_WITH_DEV_ENV
+    void OnShaderReloading(Asset* obj);
+#endif
+};
@@ -937,6 +937,7 @@ CODE
 // System includes
 #include <stdio.h>      // vsnprintf, sscanf, printf
 #include <stdint.h>     // intptr_t
+#include <atomic>       // std::atomic
 
 // [Windows] On non-Visual Studio compilers, we default to IMGUI_DISABLE_WIN32_DEFAULT_IME_FUNCTIONS unless explicitly enabled
 #if defined(_WIN32) && !defined(_MSC_VER) && !defined(IMGUI_ENABLE_WIN32_DEFAULT_IME_FUNCTIONS) && !defined(IMGUI_DISABLE_WIN32_DEFAULT_IME_FUNCTIONS)
@@ -1089,6 +1090,7 @@ static void             UpdateKeyRoutingTable(ImGuiKeyRoutingTable* rt);
 
 // Misc
 static void             UpdateSettings();
+static void             UpdateTextCaches();
 static bool             UpdateWindowManualResize(ImGuiWindow* window, const ImVec2& size_auto_fit, int* border_held, int resize_grip_count, ImU32 resize_grip_col[4], const ImRect& visibility_rect);
 static void             RenderWindowOuterBorders(ImGuiWindow* window);
 static void             RenderWindowDecorations(ImGuiWindow* window, const ImRect& title_bar_rect, bool title_bar_is_highlight, bool handle_borders_and_resize_grips, int resize_grip_count, const ImU32 resize_grip_col[4], float resize_grip_draw_size);
@@ -1143,6 +1145,9 @@ static ImGuiMemAllocFunc    GImAllocatorAllocFunc = MallocWrapper;
 static ImGuiMemFreeFunc     GImAllocatorFreeFunc = FreeWrapper;
 static void*                GImAllocatorUserData = NULL;
 
+// Active allocations of all contexts and threads (eg. font atlas built in the background), published to io.MetricsActiveAllocations by NewFrame()
+static std::atomic<int>     GImAllocatorActiveAllocations(0);
+
 //-----------------------------------------------------------------------------
 // [SECTION] USER FACING STRUCTURES (ImGuiStyle, ImGuiIO)
 //-----------------------------------------------------------------------------
@@ -1189,6 +1194,7 @@ ImGuiStyle::ImGuiStyle()
     MouseCursorScale        = 1.0f;             // Scale software rendered mouse cursor (when io.MouseDrawCursor is enabled). May be removed later.
     AntiAliasedLines        = true;             // Enable anti-aliased lines/borders. Disable if you are really tight on CPU/GPU.
     AntiAliasedLinesUseTex  = true;             // Enable anti-aliased lines/borders using textures where possible. Require backend to render with bilinear filtering (NOT point/nearest filtering).
+    AntiAliasedLinesUseSimd = true;             // Tessellate anti-aliased lines/borders with SSE instructions when available.
     AntiAliasedFill         = true;             // Enable anti-aliased filled shapes (rounded rectangles, circles, etc.).
     CurveTessellationTol    = 1.25f;            // Tessellation tolerance when using PathBezierCurveTo() without a specific number of segments. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
     CircleTessellationMaxError = 0.30f;         // Maximum error (in pixels) allowed when using AddCircle()/AddCircleFilled() or drawing rounded corner rectangles with no explicit segment count specified. Decrease for higher quality but more geometry.
@@ -1280,6 +1286,8 @@ ImGuiIO::ImGuiIO()
     ConfigWindowsResizeFromEdges = true;
     ConfigWindowsMoveFromTitleBarOnly = false;
     ConfigMemoryCompactTimer = 60.0f;
+    ConfigTextSizeCache = false;
+    ConfigTextLayoutCache = false;
     ConfigDebugBeginReturnValueOnce = false;
     ConfigDebugBeginReturnValueLoop = false;
 
@@ -3312,6 +3320,52 @@ void ImGui::RenderTextWrapped(ImVec2 pos, const char* text, const char* text_end
     }
 }
 
+// Render the visible lines of the text layout (see GetTextLayout())
+void ImGui::RenderTextLayout(ImVec2 pos, const char* text, const ImGuiTextLayout* layout)
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+    ImDrawList* draw_list = window->DrawList;
+    const ImVec4& clip_rect = draw_list->_CmdHeader.ClipRect;
+    const float x = IM_FLOOR(pos.x);
+    const float y = IM_FLOOR(pos.y);
+
+    // Binary search the first visible line
+    const ImGuiTextLayoutLine* lines = layout->Lines.Data;
+    int line_n = 0;
+    for (int count = layout->Lines.Size; count > 0; )
+    {
+        const int step = count >> 1;
+        if (y + lines[line_n + step].Y + g.FontSize < clip_rect.y)
+        {
+            line_n += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    // Only the text position is aligned to pixels, lines are offset by the font size like in ImFont::RenderText() (which would align each line again, eg. with fractional font size)
+    const ImU32 col = GetColorU32(ImGuiCol_Text);
+    for (; line_n < layout->Lines.Size; line_n++)
+    {
+        const ImGuiTextLayoutLine& line = lines[line_n];
+        const float line_y = y + line.Y;
+        if (line_y > clip_rect.w)
+            break;
+        const float line_y_aligned = IM_FLOOR(line_y);
+        const int vtx_start = draw_list->VtxBuffer.Size;
+        draw_list->AddText(g.Font, g.FontSize, ImVec2(x, line_y_aligned), col, text + line.Offset, text + line.End);
+        if (line_y != line_y_aligned)
+            for (ImDrawVert* vtx = draw_list->VtxBuffer.Data + vtx_start; vtx < draw_list->_VtxWritePtr; vtx++)
+                vtx->pos.y += line_y - line_y_aligned;
+    }
+    if (g.LogEnabled)
+        LogRenderedText(&pos, text, text + layout->TextLen);
+}
+
 // Default clip_rect uses (pos_min,pos_max)
 // Handle clipping on CPU immediately (vs typically let the GPU clip the triangles that are overlapping the clipping rectangle edges)
 // FIXME-OPT: Since we have or calculate text_size we could coarse clip whole block immediately, especally for text above draw_list->DrawList.
@@ -3670,6 +3724,8 @@ void ImGui::Shutdown()
 
     g.ClipboardHandlerData.clear();
     g.MenusIdSubmittedThisFrame.clear();
+    g.TextSizeCache.clear_free_memory();
+    g.TextLayoutCache.clear_free_memory();
     g.InputTextState.ClearFreeMemory();
     g.InputTextDeactivatedState.ClearFreeMemory();
 
@@ -4206,8 +4262,7 @@ float ImGui::CalcWrapWidthForPos(const ImVec2& pos, float wrap_pos_x)
 // IM_ALLOC() == ImGui::MemAlloc()
 void* ImGui::MemAlloc(size_t size)
 {
-    if (ImGuiContext* ctx = GImGui)
-        ctx->IO.MetricsActiveAllocations++;
+    GImAllocatorActiveAllocations.fetch_add(1, std::memory_order_relaxed);
     return (*GImAllocatorAllocFunc)(size, GImAllocatorUserData);
 }
 
@@ -4215,8 +4270,7 @@ void* ImGui::MemAlloc(size_t size)
 void ImGui::MemFree(void* ptr)
 {
     if (ptr)
-        if (ImGuiContext* ctx = GImGui)
-            ctx->IO.MetricsActiveAllocations--;
+        GImAllocatorActiveAllocations.fetch_sub(1, std::memory_order_relaxed);
     return (*GImAllocatorFreeFunc)(ptr, GImAllocatorUserData);
 }
 
@@ -4540,6 +4594,7 @@ void ImGui::NewFrame()
     g.FramerateSecPerFrameIdx = (g.FramerateSecPerFrameIdx + 1) % IM_ARRAYSIZE(g.FramerateSecPerFrame);
     g.FramerateSecPerFrameCount = ImMin(g.FramerateSecPerFrameCount + 1, IM_ARRAYSIZE(g.FramerateSecPerFrame));
     g.IO.Framerate = (g.FramerateSecPerFrameAccum > 0.0f) ? (1.0f / (g.FramerateSecPerFrameAccum / (float)g.FramerateSecPerFrameCount)) : FLT_MAX;
+    g.IO.MetricsActiveAllocations = GImAllocatorActiveAllocations.load(std::memory_order_relaxed);
 
     // Process input queue (trickle as many events as possible), turn events into writes to IO structure
     g.InputEventsTrail.resize(0);
@@ -4563,11 +4618,16 @@ void ImGui::NewFrame()
         g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AntiAliasedLines;
     if (g.Style.AntiAliasedLinesUseTex && !(g.Font->ContainerAtlas->Flags & ImFontAtlasFlags_NoBakedLines))
         g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AntiAliasedLinesUseTex;
+    if (g.Style.AntiAliasedLinesUseSimd)
+        g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AntiAliasedLinesUseSimd;
     if (g.Style.AntiAliasedFill)
         g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AntiAliasedFill;
     if (g.IO.BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset)
         g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AllowVtxOffset;
 
+    // Start a new generation of cached text sizes and layouts
+    UpdateTextCaches();
+
     // Mark rendering data as invalid to prevent user who may have a handle on it to use it.
     for (ImGuiViewportP* viewport : g.Viewports)
         viewport->DrawDataP.Valid = false;
@@ -5136,6 +5196,150 @@ void ImGui::Render()
     CallContextHooks(&g, ImGuiContextHookType_RenderPost);
 }
 
+// Seed of the text caches keys. The atlas glyphs version invalidates texts measured before glyphs got added or removed.
+static ImU64 TextCacheSeed(ImFont* font, float font_size, float wrap_width)
+{
+    ImU32 sizes[2];
+    memcpy(sizes, &font_size, 4);
+    memcpy(sizes + 1, &wrap_width, 4);
+    const ImU64 h = (ImU64)(size_t)font ^ ((ImU64)(ImU32)font->ContainerAtlas->GlyphsVersion << 32);
+    return (h ^ (((ImU64)sizes[0] << 32) | sizes[1])) * 0x9E3779B97F4A7C15ULL;
+}
+
+// Key of the text in the text caches.
+// Not using ImHashData() as hashing 8 bytes at a time is required for lookups to be cheaper than measuring short labels, and 64-bit keys make collisions negligible.
+static ImU64 TextCacheHash(const char* text, const char* text_end, ImU64 seed)
+{
+    ImU64 h = seed ^ (ImU64)(text_end - text);
+    for (; text_end - text >= 8; text += 8)
+    {
+        ImU64 v;
+        memcpy(&v, text, 8);
+        h = (h ^ v) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    ImU64 v = 0;
+    for (int n = 0; text < text_end; n += 8)
+        v |= (ImU64)(unsigned char)*text++ << n;
+    h = (h ^ v) * 0x94D049BB133111EBULL;
+    h ^= h >> 29;
+    return h != 0 ? h : 1; // 0 is reserved for empty slots
+}
+
+static ImGuiTextSizeCacheEntry* TextSizeCacheFind(ImGuiTextSizeCache* cache, ImU64 key, int text_len)
+{
+    if (cache->Entries.Size == 0)
+        return NULL;
+    const ImU64 mask = (ImU64)cache->Entries.Size - 1;
+    for (ImU64 i = key & mask; ; i = (i + 1) & mask)
+    {
+        ImGuiTextSizeCacheEntry* entry = &cache->Entries.Data[i];
+        if (entry->Key == key && entry->TextLen == text_len)
+            return entry;
+        if (entry->Key == 0)
+            return NULL; // Table is never full
+    }
+}
+
+static void TextSizeCacheInsert(ImGuiTextSizeCache* cache, const ImGuiTextSizeCacheEntry& entry)
+{
+    const ImU64 mask = (ImU64)cache->Entries.Size - 1;
+    ImU64 i = entry.Key & mask;
+    while (cache->Entries.Data[i].Key != 0)
+        i = (i + 1) & mask;
+    cache->Entries.Data[i] = entry;
+    cache->EntriesCount++;
+}
+
+static void TextSizeCacheAdd(ImGuiTextSizeCache* cache, const ImGuiTextSizeCacheEntry& entry)
+{
+    if ((cache->EntriesCount + 1) * 2 > cache->Entries.Size)
+    {
+        // Evict entries not used in the current or previous frame and resize the table so it's at most a quarter full
+        ImVector<ImGuiTextSizeCacheEntry> old_entries;
+        old_entries.swap(cache->Entries);
+        int live_count = 0;
+        for (const ImGuiTextSizeCacheEntry& old_entry : old_entries)
+            if (old_entry.Key != 0 && old_entry.LastFrame >= entry.LastFrame - 1)
+                live_count++;
+        int new_size = 64;
+        while (new_size < (live_count + 1) * 4)
+            new_size *= 2;
+        cache->Entries.resize(new_size);
+        cache->clear();
+        for (const ImGuiTextSizeCacheEntry& old_entry : old_entries)
+            if (old_entry.Key != 0 && old_entry.LastFrame >= entry.LastFrame - 1)
+                TextSizeCacheInsert(cache, old_entry);
+    }
+    TextSizeCacheInsert(cache, entry);
+}
+
+static void ImGui::UpdateTextCaches()
+{
+    ImGuiContext& g = *GImGui;
+
+    // Text sizes
+    ImGuiTextSizeCache& sizes = g.TextSizeCache;
+    sizes.HitsLastFrame = sizes.Hits;
+    sizes.MissesLastFrame = sizes.Misses;
+    sizes.Hits = sizes.Misses = 0;
+    if (!g.IO.ConfigTextSizeCache)
+    {
+        if (sizes.FontAtlas != NULL)
+            sizes.clear_free_memory();
+    }
+    else if (sizes.FontAtlas != g.IO.Fonts)
+    {
+        // Drop sizes measured with another font atlas (eg. rebuilt at a different DPI)
+        sizes.clear();
+        sizes.FontAtlas = g.IO.Fonts;
+    }
+
+    // Text layouts
+    ImGuiTextLayoutCache& layouts = g.TextLayoutCache;
+    layouts.HitsLastFrame = layouts.Hits;
+    layouts.MissesLastFrame = layouts.Misses;
+    layouts.IncrementalMissesLastFrame = layouts.IncrementalMisses;
+    layouts.Hits = layouts.Misses = layouts.IncrementalMisses = 0;
+    if (!g.IO.ConfigTextLayoutCache)
+    {
+        if (layouts.FontAtlas != NULL)
+            layouts.clear_free_memory();
+    }
+    else if (layouts.FontAtlas != g.IO.Fonts)
+    {
+        layouts.clear();
+        layouts.FontAtlas = g.IO.Fonts;
+    }
+    else
+    {
+        // Evict layouts not used in the last frame
+        ImPool<ImGuiTextLayout>& pool = layouts.Layouts;
+        for (int n = 0; n < pool.GetMapSize(); n++)
+            if (ImGuiTextLayout* layout = pool.TryGetMapData(n))
+                if (layout->LastFrame < g.FrameCount - 1)
+                    pool.Remove(pool.Map.Data[n].key, layout);
+
+        // Drop the keys of evicted layouts (texts that changed leave their old key behind)
+        if (pool.Map.Data.Size > pool.GetAliveCount() * 2 + 64)
+        {
+            int alive_n = 0;
+            for (const ImGuiStorage::ImGuiStoragePair& pair : pool.Map.Data)
+                if (pair.val_i != -1)
+                    pool.Map.Data[alive_n++] = pair;
+            pool.Map.Data.resize(alive_n);
+        }
+        if (layouts.SourceLayouts.Data.Size > pool.GetAliveCount() * 2 + 64)
+        {
+            int alive_n = 0;
+            for (const ImGuiStorage::ImGuiStoragePair& pair : layouts.SourceLayouts.Data)
+                if (pool.GetByKey((ImGuiID)pair.val_i) != NULL)
+                    layouts.SourceLayouts.Data[alive_n++] = pair;
+            layouts.SourceLayouts.Data.resize(alive_n);
+        }
+    }
+}
+
 // Calculate text size. Text can be multi-line. Optionally ignore text after a ## marker.
 // CalcTextSize("") should return ImVec2(0.0f, g.FontSize)
 ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_text_after_double_hash, float wrap_width)
@@ -5152,6 +5356,23 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
     const float font_size = g.FontSize;
     if (text == text_display_end)
         return ImVec2(0.0f, font_size);
+
+    // Lookup the size measured in the last frames
+    ImGuiTextSizeCache* cache = (g.IO.ConfigTextSizeCache && g.TextSizeCache.FontAtlas != NULL) ? &g.TextSizeCache : NULL;
+    ImU64 cache_key = 0;
+    if (cache)
+    {
+        if (text_display_end == NULL)
+            text_display_end = text + strlen(text);
+        cache_key = TextCacheHash(text, text_display_end, TextCacheSeed(font, font_size, wrap_width));
+        if (ImGuiTextSizeCacheEntry* entry = TextSizeCacheFind(cache, cache_key, (int)(text_display_end - text)))
+        {
+            entry->LastFrame = g.FrameCount;
+            cache->Hits++;
+            return entry->Size;
+        }
+    }
+
     ImVec2 text_size = font->CalcTextSizeA(font_size, FLT_MAX, wrap_width, text, text_display_end, NULL);
 
     // Round
@@ -5161,9 +5382,153 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
     // - https://embarkstudios.github.io/rust-gpu/api/src/libm/math/ceilf.rs.html
     text_size.x = IM_FLOOR(text_size.x + 0.99999f);
 
+    if (cache)
+    {
+        ImGuiTextSizeCacheEntry entry;
+        entry.Key = cache_key;
+        entry.TextLen = (int)(text_display_end - text);
+        entry.LastFrame = g.FrameCount;
+        entry.Size = text_size;
+        TextSizeCacheAdd(cache, entry);
+        cache->Misses++;
+    }
     return text_size;
 }
 
+static inline ImGuiID TextCacheFoldKey(ImU64 key)
+{
+    return (ImGuiID)(key ^ (key >> 32));
+}
+
+// Break the text the same way as ImFont::CalcTextSizeA() and ImFont::RenderText() do with word-wrapping, starting from the last line in 'lines' (previous lines are kept)
+static ImVec2 TextLayoutBreakLines(ImVector<ImGuiTextLayoutLine>* lines, ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end)
+{
+    const float scale = font_size / font->FontSize;
+    ImGuiTextLayoutLine line = lines->back();
+    lines->pop_back();
+    ImVec2 text_size(line.MaxWidth, line.Y);
+    float line_width = 0.0f;
+    const char* s = text + line.Offset;
+    while (s < text_end)
+    {
+        // Lines end at the wrapping position or at the line feed (wrapping position past it is the same as the one found from the next line start)
+        // The wrapping position may depend on the text far past the line end (eg. a long word following short ones), so the end of the text read is kept too.
+        const char* scan_end = text_end;
+        const char* line_end = font->CalcWordWrapPositionA(scale, s, text_end, wrap_width, &scan_end);
+        if (line_end == s + 1 && line_end < text_end && (unsigned char)*s >= 0x80)
+        {
+            unsigned int c;
+            line_end = s + ImTextCharFromUtf8(&c, s, text_end); // Wrap width is too small to fit anything: whole character is displayed
+            scan_end = ImMax(scan_end, line_end);
+        }
+        int line_scan_end = (line_end < text_end) ? (int)(scan_end - text) : (int)(text_end - text) + 1; // Line ending at the text end depends on where the text ends
+        const char* next_line = (const char*)memchr(s, '\n', line_end - s);
+        if (next_line)
+        {
+            line_end = next_line++;
+            line_scan_end = (int)(next_line - text);
+        }
+        else if (line_end < text_end)
+        {
+            // Wrapping skips upcoming blanks
+            next_line = line_end;
+            while (next_line < text_end && ImCharIsBlankA(*next_line))
+                next_line++;
+            line_scan_end = ImMax(line_scan_end, (int)(next_line - text) + 1);
+            if (next_line < text_end && *next_line == '\n')
+                next_line++;
+        }
+
+        line.Offset = (int)(s - text);
+        line.End = (int)(line_end - text);
+        line.ScanEnd = line_scan_end;
+        line.Y = text_size.y;
+        line.MaxWidth = text_size.x;
+        lines->push_back(line);
+        line_width = font->CalcTextSizeA(font_size, FLT_MAX, 0.0f, s, line_end).x;
+        if (text_size.x < line_width)
+            text_size.x = line_width;
+        if (next_line == NULL)
+            break;
+        text_size.y += font_size;
+        line_width = 0.0f;
+        s = next_line;
+    }
+    if (line_width > 0.0f || text_size.y == 0.0f)
+        text_size.y += font_size;
+    return text_size;
+}
+
+ImGuiTextLayout* ImGui::GetTextLayout(const char* text, const char* text_end, float wrap_width)
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiTextLayoutCache& cache = g.TextLayoutCache;
+    IM_ASSERT(cache.FontAtlas != NULL && "Need io.ConfigTextLayoutCache to be set when calling NewFrame().");
+    IM_ASSERT(wrap_width > 0.0f);
+    if (text_end == NULL)
+        text_end = text + strlen(text);
+    ImFont* font = g.Font;
+    const float font_size = g.FontSize;
+    const int text_len = (int)(text_end - text);
+    const ImU64 seed = TextCacheSeed(font, font_size, wrap_width);
+    const ImU64 key = TextCacheHash(text, text_end, seed);
+    const ImGuiID layout_id = TextCacheFoldKey(key);
+    ImGuiTextLayout* layout = cache.Layouts.GetByKey(layout_id);
+    if (layout && layout->Key == key && layout->TextLen == text_len)
+    {
+        layout->LastFrame = g.FrameCount;
+        cache.Hits++;
+        return layout;
+    }
+
+    // When the layout last built from the same text pointer was for a text starting with the same contents, its lines before the restart line are kept
+    // (their breaks don't depend on the text past the prefix) and only the rest of the text is broken again. Otherwise the whole text is broken.
+    ImVector<ImGuiTextLayoutLine>& lines = cache.TempLines;
+    lines.resize(0);
+    const ImGuiID source_id = TextCacheFoldKey(TextCacheHash((const char*)&text, (const char*)&text + sizeof(text), seed));
+    if (ImGuiTextLayout* prev_layout = cache.Layouts.GetByKey((ImGuiID)cache.SourceLayouts.GetInt(source_id)))
+        if (prev_layout->RestartLine > 0 && prev_layout->PrefixLen <= text_len && TextCacheHash(text, text + prev_layout->PrefixLen, seed) == prev_layout->PrefixHash)
+        {
+            lines.resize(prev_layout->RestartLine + 1);
+            memcpy(lines.Data, prev_layout->Lines.Data, (size_t)lines.size_in_bytes());
+            cache.IncrementalMisses++;
+        }
+    if (lines.Size == 0)
+    {
+        ImGuiTextLayoutLine first_line = { 0, 0, 0, 0.0f, 0.0f };
+        lines.push_back(first_line);
+    }
+    ImVec2 text_size = TextLayoutBreakLines(&lines, font, font_size, wrap_width, text, text_end);
+    text_size.x = IM_FLOOR(text_size.x + 0.99999f); // Same rounding as CalcTextSize()
+
+    // Store the layout (replaces the layout which key folds to the same id)
+    layout = cache.Layouts.GetOrAddByKey(layout_id);
+    layout->Key = key;
+    layout->TextLen = text_len;
+    layout->LastFrame = g.FrameCount;
+    layout->Size = text_size;
+    layout->Lines.swap(lines);
+
+    // Restart from the last line which previous lines were broken reading only the text before the last line start (text is most likely changed at its end)
+    layout->PrefixLen = layout->RestartLine = 0;
+    if (layout->Lines.Size > 1)
+    {
+        const int last_line_offset = layout->Lines.back().Offset;
+        for (int prefix_len = 0, line_n = 1; line_n < layout->Lines.Size; line_n++)
+        {
+            prefix_len = ImMax(prefix_len, layout->Lines[line_n - 1].ScanEnd);
+            if (prefix_len > last_line_offset)
+                break;
+            layout->PrefixLen = prefix_len;
+            layout->RestartLine = line_n;
+        }
+    }
+    layout->PrefixHash = TextCacheHash(text, text + layout->PrefixLen, seed);
+    cache.SourceLayouts.SetInt(source_id, (int)layout_id);
+    cache.Misses++;
+    return layout;
+}
+
 // Find window given position, search front-to-back
 // FIXME: Note that we have an inconsequential lag here: OuterRectClipped is updated in Begin(), so windows moved programmatically
 // with SetWindowPos() and not SetNextWindowPos() will have that rectangle lagging by a frame at the time FindHoveredWindow() is
@@ -13671,6 +14036,10 @@ void ImGui::ShowMetricsWindow(bool* p_open)
     Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
     Text("%d vertices, %d indices (%d triangles)", io.MetricsRenderVertices, io.MetricsRenderIndices, io.MetricsRenderIndices / 3);
     Text("%d visible windows, %d active allocations", io.MetricsRenderWindows, io.MetricsActiveAllocations);
+    if (io.ConfigTextSizeCache)
+        Text("Text size cache: %d entries, %d hits, %d misses (last frame)", g.TextSizeCache.EntriesCount, g.TextSizeCache.HitsLastFrame, g.TextSizeCache.MissesLastFrame);
+    if (io.ConfigTextLayoutCache)
+        Text("Text layout cache: %d layouts, %d hits, %d misses, %d incremental (last frame)", g.TextLayoutCache.Layouts.GetAliveCount(), g.TextLayoutCache.HitsLastFrame, g.TextLayoutCache.MissesLastFrame, g.TextLayoutCache.IncrementalMissesLastFrame);
     //SameLine(); if (SmallButton("GC")) { g.GcCompactAll = true; }
 
     Separator();
@@ -149,6 +149,7 @@ struct ImFontBuilderIO;             // Opaque interface to a font builder (stb_t
 struct ImFontConfig;                // Configuration data when adding a font or merging fonts
 struct ImFontGlyph;                 // A single font glyph (code point + coordinates within in ImFontAtlas + offset)
 struct ImFontGlyphRangesBuilder;    // Helper to build glyph ranges from text/string data
+struct ImFontIndexPage;             // Glyphs lookup for a block of 256 code points
 struct ImColor;                     // Helper functions to create a color that can be converted to either u32 or float4 (*OBSOLETE* please avoid using)
 struct ImGuiContext;                // Dear ImGui context (opaque structure, unless including imgui_internal.h)
 struct ImGuiIO;                     // Main configuration and I/O between your application and ImGui
@@ -1924,6 +1925,7 @@ struct ImGuiStyle
     float       MouseCursorScale;           // Scale software rendered mouse cursor (when io.MouseDrawCursor is enabled). May be removed later.
     bool        AntiAliasedLines;           // Enable anti-aliased lines/borders. Disable if you are really tight on CPU/GPU. Latched at the beginning of the frame (copied to ImDrawList).
     bool        AntiAliasedLinesUseTex;     // Enable anti-aliased lines/borders using textures where possible. Require backend to render with bilinear filtering (NOT point/nearest filtering). Latched at the beginning of the frame (copied to ImDrawList).
+    bool        AntiAliasedLinesUseSimd;    // Tessellate anti-aliased lines/borders with SSE instructions when available (same geometry, faster for long polylines). Latched at the beginning of the frame (copied to ImDrawList).
     bool        AntiAliasedFill;            // Enable anti-aliased edges around filled shapes (rounded rectangles, circles, etc.). Disable if you are really tight on CPU/GPU. Latched at the beginning of the frame (copied to ImDrawList).
     float       CurveTessellationTol;       // Tessellation tolerance when using PathBezierCurveTo() without a specific number of segments. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
     float       CircleTessellationMaxError; // Maximum error (in pixels) allowed when using AddCircle()/AddCircleFilled() or drawing rounded corner rectangles with no explicit segment count specified. Decrease for higher quality but more geometry.
@@ -1989,6 +1991,8 @@ struct ImGuiIO
     bool        ConfigWindowsResizeFromEdges;   // = true           // Enable resizing of windows from their edges and from the lower-left corner. This requires (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors) because it needs mouse cursor feedback. (This used to be a per-window ImGuiWindowFlags_ResizeFromAnySide flag)
     bool        ConfigWindowsMoveFromTitleBarOnly; // = false       // Enable allowing to move windows only when clicking on their title bar. Does not apply to windows without a title bar.
     float       ConfigMemoryCompactTimer;       // = 60.0f          // Timer (in seconds) to free transient windows/tables memory buffers when unused. Set to -1.0f to disable.
+    bool        ConfigTextSizeCache;            // = false          // Cache the sizes returned by CalcTextSize() between frames (keyed by font, font size, wrap width and text hash). Speeds up UI measuring the same labels every frame (eg. large tables). Sizes not used during the last frame are evicted.
+    bool        ConfigTextLayoutCache;          // = false          // Cache the line breaks of wrapped text between frames (keyed by font, font size, wrap width and text hash). TextWrapped() then only renders the visible lines and text edited at the end only breaks its last lines again. Layouts not used during the last frame are evicted.
 
     // Inputs Behaviors
     // (other variables, ones which are expected to be tweaked within UI code, are exposed in ImGuiStyle)
@@ -2089,7 +2093,7 @@ struct ImGuiIO
     int         MetricsRenderIndices;               // Indices output during last call to Render() = number of triangles * 3
     int         MetricsRenderWindows;               // Number of visible windows
     int         MetricsActiveWindows;               // Number of active windows
-    int         MetricsActiveAllocations;           // Number of active allocations, updated by MemAlloc/MemFree based on current context. May be off if you have multiple imgui contexts.
+    int         MetricsActiveAllocations;           // Number of active allocations, counted by MemAlloc/MemFree for all contexts and threads and updated by NewFrame().
     ImVec2      MouseDelta;                         // Mouse delta. Note that this is zero if either current or previous position are invalid (-FLT_MAX,-FLT_MAX), so a disappearing/reappearing mouse won't have a huge delta.
 
     // Legacy: before 1.87, we required backend to fill io.KeyMap[] (imgui->native map) during initialization and io.KeysDown[] (native indices) every frame.
@@ -2612,6 +2616,7 @@ enum ImDrawListFlags_
     ImDrawListFlags_AntiAliasedLinesUseTex  = 1 << 1,  // Enable anti-aliased lines/borders using textures when possible. Require backend to render with bilinear filtering (NOT point/nearest filtering).
     ImDrawListFlags_AntiAliasedFill         = 1 << 2,  // Enable anti-aliased edge around filled shapes (rounded rectangles, circles).
     ImDrawListFlags_AllowVtxOffset          = 1 << 3,  // Can emit 'VtxOffset > 0' to allow large meshes. Set when 'ImGuiBackendFlags_RendererHasVtxOffset' is enabled.
+    ImDrawListFlags_AntiAliasedLinesUseSimd = 1 << 4,  // Tessellate anti-aliased lines with SSE instructions when available (IMGUI_ENABLE_SSE). Produces the same vertices as the scalar version.
 };
 
 // Draw command list
@@ -2813,6 +2818,14 @@ struct ImFontGlyph
     float           U0, V0, U1, V1;     // Texture coordinates
 };
 
+// Glyphs lookup for a block of IM_FONT_INDEX_PAGE_SIZE code points (see ImFont::IndexPages)
+#define IM_FONT_INDEX_PAGE_SIZE     256
+struct ImFontIndexPage
+{
+    float           AdvanceX[IM_FONT_INDEX_PAGE_SIZE];  // Glyphs->AdvanceX by code point (FallbackAdvanceX for missing glyphs)
+    ImWchar         Lookup[IM_FONT_INDEX_PAGE_SIZE];    // Index in ImFont::Glyphs by code point ((ImWchar)-1 for missing glyphs)
+};
+
 // Helper to build glyph ranges from text/string data. Feed your application strings/characters to it then call BuildRanges().
 // This is essentially a tightly packed of vector of 64k booleans = 8KB storage.
 struct ImFontGlyphRangesBuilder
@@ -2849,6 +2862,9 @@ enum ImFontAtlasFlags_
     ImFontAtlasFlags_NoPowerOfTwoHeight = 1 << 0,   // Don't round the height to next power of two
     ImFontAtlasFlags_NoMouseCursors     = 1 << 1,   // Don't build software mouse cursors into the atlas (save a little texture memory)
     ImFontAtlasFlags_NoBakedLines       = 1 << 2,   // Don't build thick line textures into the atlas (save a little texture memory, allow support for point/nearest filtering). The AntiAliasedLinesUseTex features uses them, otherwise they will be rendered using polygons (more expensive for CPU/GPU).
+    ImFontAtlasFlags_SignedDistanceField = 1 << 3,  // Build glyphs as signed distance fields (see TexSdfPadding) so text can be scaled without blur. Renderer has to decode them (outline at 0.5). Oversampling and RasterizerMultiply are ignored. Implies ImFontAtlasFlags_NoBakedLines.
+    ImFontAtlasFlags_PackBestFit        = 1 << 4,   // Pack rectangles with the skyline best-fit heuristic (picks the lowest position with the least wasted area, ~2x slower packing) instead of bottom-left
+    ImFontAtlasFlags_PackSortByArea     = 1 << 5,   // Pack rectangles sorted by area instead of by height
 };
 
 // Load and rasterize multiple TTF/OTF fonts into a same texture. The font atlas will build a single texture holding:
@@ -2939,8 +2955,15 @@ struct ImFontAtlas
     ImTextureID                 TexID;              // User data to refer to the texture once it has been uploaded to user's graphic systems. It is passed back to you during rendering via the ImDrawCmd structure.
     int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
     int                         TexGlyphPadding;    // Padding between glyphs within texture in pixels. Defaults to 1. If your rendering method doesn't rely on bilinear filtering you may set this to 0 (will also need to set AntiAliasedLinesUseTex = false).
+    int                         TexSdfPadding;      // Distance in pixels encoded around glyphs with ImFontAtlasFlags_SignedDistanceField (0 at that distance outside, 255 at that distance inside). Defaults to 4.
     bool                        Locked;             // Marked as Locked by ImGui::NewFrame() so attempt to modify the atlas will assert.
     void*                       UserData;           // Store your own atlas related user-data (if e.g. you have multiple font atlas).
+    void                        (*GlyphMissingCallback)(ImFont* font, ImWchar c); // Called by ImFont::FindGlyph() when a font has no glyph for the character (fallback glyph is returned). Can be used to add glyphs on demand.
+    void*                       GlyphMissingUserData; // User data for GlyphMissingCallback.
+    int                         DynamicGlyphsFrame; // Frame index written into ImFont::DynamicGlyphsLastUse when a glyph added on demand is used (to evict unused glyphs).
+    int                         GlyphsVersion;      // Incremented when the glyphs lookup of any font changes (eg. glyph added on demand). Used to invalidate cached text sizes.
+    void                        (*BuildParallelFor)(int count, void (*func)(void* data, int index), void* data, void* user_data); // Optional. Runs func for every index (eg. on worker threads) and waits for completion. Used by Build() to process source fonts in parallel (memory allocator functions must be thread-safe).
+    void*                       BuildParallelForUserData; // User data for BuildParallelFor.
 
     // [Internal]
     // NB: Access texture data via GetTexData*() calls! Which will setup a default font for you.
@@ -2950,6 +2973,7 @@ struct ImFontAtlas
     unsigned int*               TexPixelsRGBA32;    // 4 component per pixel, each component is unsigned 8-bit. Total size = TexWidth * TexHeight * 4
     int                         TexWidth;           // Texture width calculated during Build().
     int                         TexHeight;          // Texture height calculated during Build().
+    float                       TexOccupancy;       // Ratio of the texture area used by packed rectangles (glyphs and custom rects including padding) calculated during Build().
     ImVec2                      TexUvScale;         // = (1.0f/TexWidth, 1.0f/TexHeight)
     ImVec2                      TexUvWhitePixel;    // Texture coordinates to a white pixel
     ImVector<ImFont*>           Fonts;              // Hold all the fonts returned by AddFont*. Fonts[0] is the default font upon calling ImGui::NewFrame(), use ImGui::PushFont()/PopFont() to change the current font.
@@ -2974,13 +2998,13 @@ struct ImFontAtlas
 // ImFontAtlas automatically loads a default embedded font for you when you call GetTexDataAsAlpha8() or GetTexDataAsRGBA32().
 struct ImFont
 {
-    // Members: Hot ~20/24 bytes (for CalcTextSize)
-    ImVector<float>             IndexAdvanceX;      // 12-16 // out //            // Sparse. Glyphs->AdvanceX in a directly indexable way (cache-friendly for CalcTextSize functions which only this this info, and are often bottleneck in large UI).
+    // Members: Hot ~32/40 bytes (for CalcTextSize)
+    ImVector<ImU16>             IndexPageMap;       // 12-16 // out //            // Sparse. Page in IndexPages for each block of IM_FONT_INDEX_PAGE_SIZE code points up to the highest one. Blocks without glyphs share the empty page 0.
+    ImVector<ImFontIndexPage>   IndexPages;         // 12-16 // out //            // Glyphs->AdvanceX and glyph indices in a directly indexable way (cache-friendly for CalcTextSize functions which only this this info, and are often bottleneck in large UI). Pages are allocated only for the used blocks so sparse high code points (eg. icons) don't need large tables.
     float                       FallbackAdvanceX;   // 4     // out // = FallbackGlyph->AdvanceX
     float                       FontSize;           // 4     // in  //            // Height of characters/line, set during loading (don't change after loading)
 
-    // Members: Hot ~28/40 bytes (for CalcTextSize + render loop)
-    ImVector<ImWchar>           IndexLookup;        // 12-16 // out //            // Sparse. Index glyphs by Unicode code-point.
+    // Members: Hot ~16/24 bytes (for CalcTextSize + render loop)
     ImVector<ImFontGlyph>       Glyphs;             // 12-16 // out //            // All glyphs.
     const ImFontGlyph*          FallbackGlyph;      // 4-8   // out // = FindGlyph(FontFallbackChar)
 
@@ -2998,20 +3022,23 @@ struct ImFont
     float                       Ascent, Descent;    // 4+4   // out //            // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize]
     int                         MetricsTotalSurface;// 4     // out //            // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
     ImU8                        Used4kPagesMap[(IM_UNICODE_CODEPOINT_MAX+1)/4096/8]; // 2 bytes if ImWchar=ImWchar16, 34 bytes if ImWchar==ImWchar32. Store 1-bit for each block of 4K codepoints that has one active glyph. This is mainly used to facilitate iterations across all used codepoints.
+    int                         DynamicGlyphsStart; // 4     // out // = INT_MAX  // Index of the first glyph added on demand (see ImFontAtlas::GlyphMissingCallback). Glyphs after it track their last use.
+    ImVector<int>               DynamicGlyphsLastUse; // 12-16 // out //          // ImFontAtlas::DynamicGlyphsFrame of the last FindGlyph() call for each glyph added on demand.
 
     // Methods
     IMGUI_API ImFont();
     IMGUI_API ~ImFont();
     IMGUI_API const ImFontGlyph*FindGlyph(ImWchar c) const;
     IMGUI_API const ImFontGlyph*FindGlyphNoFallback(ImWchar c) const;
-    float                       GetCharAdvance(ImWchar c) const     { return ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX[(int)c] : FallbackAdvanceX; }
+    float                       GetCharAdvance(ImWchar c) const     { const unsigned int page_n = (unsigned int)c / IM_FONT_INDEX_PAGE_SIZE; return (page_n < (unsigned int)IndexPageMap.Size) ? IndexPages.Data[IndexPageMap.Data[page_n]].AdvanceX[(unsigned int)c % IM_FONT_INDEX_PAGE_SIZE] : FallbackAdvanceX; }
+    ImWchar                     GetGlyphIndex(ImWchar c) const      { const unsigned int page_n = (unsigned int)c / IM_FONT_INDEX_PAGE_SIZE; return (page_n < (unsigned int)IndexPageMap.Size) ? IndexPages.Data[IndexPageMap.Data[page_n]].Lookup[(unsigned int)c % IM_FONT_INDEX_PAGE_SIZE] : (ImWchar)-1; }
     bool                        IsLoaded() const                    { return ContainerAtlas != NULL; }
     const char*                 GetDebugName() const                { return ConfigData ? ConfigData->Name : "<unknown>"; }
 
     // 'max_width' stops rendering after a certain width (could be turned into a 2d size). FLT_MAX to disable.
     // 'wrap_width' enable automatic word-wrapping across multiple lines to fit into given width. 0.0f to disable.
     IMGUI_API ImVec2            CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end = NULL, const char** remaining = NULL) const; // utf8
-    IMGUI_API const char*       CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const;
+    IMGUI_API const char*       CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width, const char** out_scan_end = NULL) const; // 'out_scan_end' receives the end of the text read to find the position
     IMGUI_API void              RenderChar(ImDrawList* draw_list, float size, const ImVec2& pos, ImU32 col, ImWchar c) const;
     IMGUI_API void              RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width = 0.0f, bool cpu_fine_clip = false) const;
 
@@ -3019,6 +3046,7 @@ struct ImFont
     IMGUI_API void              BuildLookupTable();
     IMGUI_API void              ClearOutputData();
     IMGUI_API void              GrowIndex(int new_size);
+    IMGUI_API void              SetGlyphIndex(ImWchar c, ImWchar glyph_index, float advance_x); // Allocates the page of the code point if needed
     IMGUI_API void              AddGlyph(const ImFontConfig* src_cfg, ImWchar c, float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float advance_x);
     IMGUI_API void              AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst = true); // Makes 'dst' character/glyph points to 'src' character/glyph. Currently needs to be called AFTER fonts have been built.
     IMGUI_API void              SetGlyphVisible(ImWchar c, bool visible);
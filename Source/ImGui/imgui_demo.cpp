@@ -474,6 +474,10 @@ void ImGui::ShowDemoWindow(bool* p_open)
             ImGui::SameLine(); HelpMarker("Enable resizing of windows from their edges and from the lower-left corner.\nThis requires (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors) because it needs mouse cursor feedback.");
             ImGui::Checkbox("io.ConfigWindowsMoveFromTitleBarOnly", &io.ConfigWindowsMoveFromTitleBarOnly);
             ImGui::Checkbox("io.ConfigMacOSXBehaviors", &io.ConfigMacOSXBehaviors);
+            ImGui::Checkbox("io.ConfigTextSizeCache", &io.ConfigTextSizeCache);
+            ImGui::SameLine(); HelpMarker("Cache the sizes returned by CalcTextSize() between frames.\nHits and misses are displayed in the Metrics window.");
+            ImGui::Checkbox("io.ConfigTextLayoutCache", &io.ConfigTextLayoutCache);
+            ImGui::SameLine(); HelpMarker("Cache the line breaks of wrapped text between frames and only render the visible lines.\nHits and misses are displayed in the Metrics window.");
             ImGui::Text("Also see Style->Rendering for rendering options.");
 
             ImGui::SeparatorText("Debug");
@@ -6208,6 +6212,8 @@ void ImGui::ShowAboutWindow(bool* p_open)
         if (io.ConfigWindowsResizeFromEdges)                            ImGui::Text("io.ConfigWindowsResizeFromEdges");
         if (io.ConfigWindowsMoveFromTitleBarOnly)                       ImGui::Text("io.ConfigWindowsMoveFromTitleBarOnly");
         if (io.ConfigMemoryCompactTimer >= 0.0f)                        ImGui::Text("io.ConfigMemoryCompactTimer = %.1f", io.ConfigMemoryCompactTimer);
+        if (io.ConfigTextSizeCache)                                     ImGui::Text("io.ConfigTextSizeCache");
+        if (io.ConfigTextLayoutCache)                                   ImGui::Text("io.ConfigTextLayoutCache");
         ImGui::Text("io.BackendFlags: 0x%08X", io.BackendFlags);
         if (io.BackendFlags & ImGuiBackendFlags_HasGamepad)             ImGui::Text(" HasGamepad");
         if (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors)        ImGui::Text(" HasMouseCursors");
@@ -6499,6 +6505,10 @@ void ImGui::ShowStyleEditor(ImGuiStyle* ref)
             ImGui::SameLine();
             HelpMarker("Faster lines using texture data. Require backend to render with bilinear filtering (not point/nearest filtering).");
 
+            ImGui::Checkbox("Anti-aliased lines use SIMD", &style.AntiAliasedLinesUseSimd);
+            ImGui::SameLine();
+            HelpMarker("Faster tessellation of long lines using SSE instructions (when available). Produces the same geometry.");
+
             ImGui::Checkbox("Anti-aliased fill", &style.AntiAliasedFill);
             ImGui::PushItemWidth(ImGui::GetFontSize() * 8);
             ImGui::DragFloat("Curve Tessellation Tolerance", &style.CurveTessellationTol, 0.02f, 0.10f, 10.0f, "%.2f");
@@ -139,6 +139,11 @@ namespace IMGUI_STB_NAMESPACE
 #define STBTT_iceil(x)      ((int)ImCeil(x))
 #define STBTT_STATIC
 #define STB_TRUETYPE_IMPLEMENTATION
+#if defined(IMGUI_ENABLE_SSE)
+#define STBTT_SSE2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define STBTT_NEON
+#endif
 #else
 #define STBTT_DEF extern
 #endif
@@ -704,6 +709,209 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
 #define IM_FIXNORMAL2F_MAX_INVLEN2          100.0f // 500.0f (see #4053, #3366)
 #define IM_FIXNORMAL2F(VX,VY)               { float d2 = VX*VX + VY*VY; if (d2 > 0.000001f) { float inv_len2 = 1.0f / d2; if (inv_len2 > IM_FIXNORMAL2F_MAX_INVLEN2) inv_len2 = IM_FIXNORMAL2F_MAX_INVLEN2; VX *= inv_len2; VY *= inv_len2; } } (void)0
 
+#if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+
+// Write the indices of 'segments_count' line segments, each segment having the indices of the previous one offset by 'step'
+// Called with constant 'idx_count' so the stores are unrolled and the indices stay in registers.
+static inline ImDrawIdx* AddPolylineSegmentsIndicesSSE(ImDrawIdx* dst, const ImDrawIdx* first_segment, const int idx_count, int segments_count, int step)
+{
+    const int vec_count = (idx_count * (int)sizeof(ImDrawIdx) + 15) / 16;
+    const int full_vec_count = (idx_count * (int)sizeof(ImDrawIdx)) / 16;
+    const int tail_size = (idx_count * (int)sizeof(ImDrawIdx)) % 16;
+    const __m128i step_vec = (sizeof(ImDrawIdx) == 2) ? _mm_set1_epi16((short)step) : _mm_set1_epi32(step);
+    __m128i v[5];
+    for (int n = 0; n < vec_count; n++)
+        v[n] = _mm_loadu_si128((const __m128i*)(const void*)(first_segment + n * 16 / sizeof(ImDrawIdx)));
+    for (; segments_count > 0; segments_count--, dst += idx_count)
+    {
+        for (int n = 0; n < full_vec_count; n++)
+            _mm_storeu_si128((__m128i*)(void*)(dst + n * 16 / sizeof(ImDrawIdx)), v[n]);
+        ImDrawIdx* tail = dst + full_vec_count * 16 / sizeof(ImDrawIdx);
+        __m128i tail_vec = v[full_vec_count < vec_count ? full_vec_count : 0];
+        if (tail_size >= 8)
+        {
+            _mm_storel_epi64((__m128i*)(void*)tail, tail_vec);
+            tail_vec = _mm_srli_si128(tail_vec, 8);
+            tail += 8 / sizeof(ImDrawIdx);
+        }
+        if (tail_size % 8 == 4)
+        {
+            const int tail_32 = _mm_cvtsi128_si32(tail_vec);
+            memcpy(tail, &tail_32, 4);
+        }
+        for (int n = 0; n < vec_count; n++)
+            v[n] = (sizeof(ImDrawIdx) == 2) ? _mm_add_epi16(v[n], step_vec) : _mm_add_epi32(v[n], step_vec);
+    }
+    return dst;
+}
+
+// Write the vertices of one or two points of the line (from the low and high halves of the positions)
+static inline ImDrawVert* AddPolylineWriteVerticesSSE(ImDrawVert* vtx, const __m128* pos, const __m128* uv, const ImU32* col, const int vtx_per_point, bool two_points)
+{
+    for (int n = 0; n < vtx_per_point; n++)
+    {
+        _mm_storeu_ps(&vtx[n].pos.x, _mm_movelh_ps(pos[n], uv[n]));
+        vtx[n].col = col[n];
+    }
+    if (!two_points)
+        return vtx + vtx_per_point;
+    vtx += vtx_per_point;
+    for (int n = 0; n < vtx_per_point; n++)
+    {
+        _mm_storeu_ps(&vtx[n].pos.x, _mm_movehl_ps(uv[n], pos[n]));
+        vtx[n].col = col[n];
+    }
+    return vtx + vtx_per_point;
+}
+
+// Anti-aliased paths of AddPolyline() with SSE, producing the same vertices and indices as the scalar version.
+// - Segment normals are computed two at a time (ImRsqrt() uses the same approximation as _mm_rsqrt_ps()).
+// - Vertices of each pair of points are written directly (no temporary points buffer).
+// - Indices of each segment are the ones of the previous segment offset by the vertices count per point, except for the segment closing the line.
+static void AddPolylineAntiAliasedSSE(ImDrawList* draw_list, const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness, bool use_texture, bool thick_line)
+{
+    const float AA_SIZE = draw_list->_FringeScale;
+    const ImU32 col_trans = col & ~IM_COL32_A_MASK;
+    const int count = closed ? points_count : points_count - 1; // The number of line segments we need to draw
+
+    // Normals of each segment are stored after the normal of the segment ending at the point (normals[i] and normals[i + 1] are averaged for point i)
+    draw_list->_Data->TempBuffer.reserve_discard(points_count + 1);
+    ImVec2* normals = draw_list->_Data->TempBuffer.Data;
+    const __m128 sign_y = _mm_castsi128_ps(_mm_setr_epi32(0, (int)0x80000000, 0, (int)0x80000000));
+    int i1 = 0;
+    for (; i1 + 2 < points_count; i1 += 2)
+    {
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(&points[i1 + 1].x), _mm_loadu_ps(&points[i1].x));
+        const __m128 sq = _mm_mul_ps(d, d);
+        const __m128 d2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128 non_zero = _mm_cmpgt_ps(d2, _mm_setzero_ps());
+        d = _mm_or_ps(_mm_and_ps(non_zero, _mm_mul_ps(d, _mm_rsqrt_ps(d2))), _mm_andnot_ps(non_zero, d));
+        _mm_storeu_ps(&normals[i1 + 1].x, _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), sign_y)); // (dy, -dx)
+    }
+    for (; i1 < count; i1++)
+    {
+        const int i2 = (i1 + 1) == points_count ? 0 : i1 + 1;
+        float dx = points[i2].x - points[i1].x;
+        float dy = points[i2].y - points[i1].y;
+        IM_NORMALIZE2F_OVER_ZERO(dx, dy);
+        normals[i1 + 1].x = dy;
+        normals[i1 + 1].y = -dx;
+    }
+    if (closed)
+        normals[0] = normals[points_count];
+    else
+        normals[points_count] = normals[points_count - 1];
+
+    // Offsets of the outer (and inner) edges from the points, and the vertices of each point
+    // (texture-based: outer edges, non-thick: center and outer edges, thick: outer and inner edges)
+    const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+    const float half_draw_size = use_texture ? ((thickness * 0.5f) + 1) : thick_line ? (half_inner_thickness + AA_SIZE) : AA_SIZE;
+    const __m128 out_scale = _mm_set1_ps(half_draw_size);
+    const __m128 in_scale = _mm_set1_ps(half_inner_thickness);
+    const int vtx_stride = use_texture ? 2 : thick_line ? 4 : 3;
+    __m128 vtx_uv[4];
+    ImU32 vtx_col[4];
+    if (use_texture)
+    {
+        const ImVec4 tex_uvs = draw_list->_Data->TexUvLines[(int)thickness];
+        vtx_uv[0] = _mm_setr_ps(tex_uvs.x, tex_uvs.y, tex_uvs.x, tex_uvs.y); vtx_col[0] = col; // Left-side outer edge
+        vtx_uv[1] = _mm_setr_ps(tex_uvs.z, tex_uvs.w, tex_uvs.z, tex_uvs.w); vtx_col[1] = col; // Right-side outer edge
+    }
+    else
+    {
+        const ImVec2 opaque_uv = draw_list->_Data->TexUvWhitePixel;
+        vtx_uv[0] = vtx_uv[1] = vtx_uv[2] = vtx_uv[3] = _mm_setr_ps(opaque_uv.x, opaque_uv.y, opaque_uv.x, opaque_uv.y);
+        vtx_col[0] = thick_line ? col_trans : col;
+        vtx_col[1] = thick_line ? col : col_trans;
+        vtx_col[2] = thick_line ? col : col_trans;
+        vtx_col[3] = col_trans;
+    }
+
+    // Add vertices for each point, two points at a time
+    // If line is not closed, the first point is generated differently as there are no normals to blend (the last point has the same normal twice)
+    ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+    const __m128 fix_min_d2 = _mm_set1_ps(0.000001f);
+    const __m128 fix_max_invlen2 = _mm_set1_ps(IM_FIXNORMAL2F_MAX_INVLEN2);
+    for (int i = 0; i < points_count; i += 2)
+    {
+        const bool pair = (i + 1 < points_count);
+        const __m128 pos = pair ? _mm_loadu_ps(&points[i].x) : _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(const void*)&points[i]);
+        __m128 dm;
+        if (pair)
+            dm = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&normals[i].x), _mm_loadu_ps(&normals[i + 1].x)), _mm_set1_ps(0.5f));
+        else
+            dm = _mm_mul_ps(_mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(const void*)&normals[i]), _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(const void*)&normals[i + 1])), _mm_set1_ps(0.5f));
+
+        // Average normals (IM_FIXNORMAL2F)
+        const __m128 sq = _mm_mul_ps(dm, dm);
+        const __m128 d2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128 fix = _mm_cmpgt_ps(d2, fix_min_d2);
+        const __m128 inv_len2 = _mm_min_ps(_mm_div_ps(_mm_set1_ps(1.0f), d2), fix_max_invlen2);
+        dm = _mm_or_ps(_mm_and_ps(fix, _mm_mul_ps(dm, inv_len2)), _mm_andnot_ps(fix, dm));
+        if (i == 0 && !closed)
+        {
+            // Use the first segment normal as is for the first point
+            const __m128 first_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, 0, 0));
+            dm = _mm_or_ps(_mm_and_ps(first_mask, _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(const void*)&normals[1])), _mm_andnot_ps(first_mask, dm));
+        }
+
+        const __m128 dm_out = _mm_mul_ps(dm, out_scale);
+        __m128 vtx_pos[4];
+        if (use_texture)
+        {
+            vtx_pos[0] = _mm_add_ps(pos, dm_out);
+            vtx_pos[1] = _mm_sub_ps(pos, dm_out);
+            vtx_write = AddPolylineWriteVerticesSSE(vtx_write, vtx_pos, vtx_uv, vtx_col, 2, pair);
+        }
+        else if (!thick_line)
+        {
+            vtx_pos[0] = pos;
+            vtx_pos[1] = _mm_add_ps(pos, dm_out);
+            vtx_pos[2] = _mm_sub_ps(pos, dm_out);
+            vtx_write = AddPolylineWriteVerticesSSE(vtx_write, vtx_pos, vtx_uv, vtx_col, 3, pair);
+        }
+        else
+        {
+            const __m128 dm_in = _mm_mul_ps(dm, in_scale);
+            vtx_pos[0] = _mm_add_ps(pos, dm_out);
+            vtx_pos[1] = _mm_add_ps(pos, dm_in);
+            vtx_pos[2] = _mm_sub_ps(pos, dm_in);
+            vtx_pos[3] = _mm_sub_ps(pos, dm_out);
+            vtx_write = AddPolylineWriteVerticesSSE(vtx_write, vtx_pos, vtx_uv, vtx_col, 4, pair);
+        }
+    }
+    draw_list->_VtxWritePtr = vtx_write;
+
+    // Add indices for each line segment (same order as the scalar version, offsets from the first vertex of the segment start point)
+    static const ImU8 offsets_texture[6] = { 2, 0, 1, 3, 1, 2 };
+    static const ImU8 offsets_thin[12] = { 3, 0, 2, 2, 5, 3, 4, 1, 0, 0, 3, 4 };
+    static const ImU8 offsets_thick[18] = { 5, 1, 2, 2, 6, 5, 5, 1, 0, 0, 4, 5, 6, 2, 3, 3, 7, 6 };
+    const ImU8* offsets = use_texture ? offsets_texture : thick_line ? offsets_thick : offsets_thin;
+    const int idx_per_segment = use_texture ? 6 : thick_line ? 18 : 12;
+    ImDrawIdx idx_pattern[24] = {};
+    for (int n = 0; n < idx_per_segment; n++)
+        idx_pattern[n] = (ImDrawIdx)(draw_list->_VtxCurrentIdx + offsets[n]);
+    ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
+    if (use_texture)
+        idx_write = AddPolylineSegmentsIndicesSSE(idx_write, idx_pattern, 6, points_count - 1, vtx_stride);
+    else if (!thick_line)
+        idx_write = AddPolylineSegmentsIndicesSSE(idx_write, idx_pattern, 12, points_count - 1, vtx_stride);
+    else
+        idx_write = AddPolylineSegmentsIndicesSSE(idx_write, idx_pattern, 18, points_count - 1, vtx_stride);
+    if (closed)
+    {
+        // Last segment ends at the first point
+        const unsigned int idx1 = draw_list->_VtxCurrentIdx + (points_count - 1) * vtx_stride;
+        const unsigned int idx2 = draw_list->_VtxCurrentIdx;
+        for (int n = 0; n < idx_per_segment; n++)
+            idx_write[n] = (ImDrawIdx)(offsets[n] >= vtx_stride ? idx2 + offsets[n] - vtx_stride : idx1 + offsets[n]);
+        idx_write += idx_per_segment;
+    }
+    draw_list->_IdxWritePtr = idx_write;
+}
+
+#endif // #if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 // We avoid using the ImVec2 math operators here to reduce cost to a minimum for debug/non-inlined builds.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, ImDrawFlags flags, float thickness)
@@ -739,6 +947,16 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         const int vtx_count = use_texture ? (points_count * 2) : (thick_line ? points_count * 4 : points_count * 3);
         PrimReserve(idx_count, vtx_count);
 
+#if defined(IMGUI_ENABLE_SSE) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+        if (Flags & ImDrawListFlags_AntiAliasedLinesUseSimd)
+        {
+            // [PATH 1] and [PATH 2] with SSE (same output)
+            AddPolylineAntiAliasedSSE(this, points, points_count, col, closed, thickness, use_texture, thick_line);
+            _VtxCurrentIdx += (ImDrawIdx)vtx_count;
+            return;
+        }
+#endif
+
         // Temporary buffer
         // The first <points_count> items are normals at each line point, then after that there are either 2 or 4 temp points for each line point
         _Data->TempBuffer.reserve_discard(points_count * ((use_texture || !thick_line) ? 3 : 5));
@@ -2023,6 +2241,7 @@ ImFontAtlas::ImFontAtlas()
 {
     memset(this, 0, sizeof(*this));
     TexGlyphPadding = 1;
+    TexSdfPadding = 4;
     PackIdMouseCursors = PackIdLines = -1;
 }
 
@@ -2389,15 +2608,156 @@ static void UnpackBitVectorToFlatIndexList(const ImBitVector* in, ImVector<int>*
                     out->push_back((int)(((it - it_begin) << 5) + bit_n));
 }
 
+static inline int ImFontAtlasBuildCountBits(ImU32 v)
+{
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (int)((((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
+// Runs job for every source font, on multiple threads if ImFontAtlas::BuildParallelFor is set. Jobs may allocate only if the allocator functions are thread-safe.
+struct ImFontBuildJobData
+{
+    ImFontAtlas*            Atlas;
+    ImFontBuildSrcData*     SrcData;
+    const stbtt_pack_context* PackContext;
+};
+
+static void ImFontAtlasBuildParallelFor(ImFontBuildJobData* data, void (*func)(void* data, int src_i))
+{
+    ImFontAtlas* atlas = data->Atlas;
+    if (atlas->BuildParallelFor != NULL && atlas->ConfigData.Size > 1)
+        atlas->BuildParallelFor(atlas->ConfigData.Size, func, data, atlas->BuildParallelForUserData);
+    else
+        for (int src_i = 0; src_i < atlas->ConfigData.Size; src_i++)
+            func(data, src_i);
+}
+
+// Find requested codepoints which are present in the font data
+static void ImFontAtlasBuildFindGlyphsJob(void* data, int src_i)
+{
+    ImFontBuildSrcData& src_tmp = ((ImFontBuildJobData*)data)->SrcData[src_i];
+    for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
+        for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
+            if (stbtt_FindGlyphIndex(&src_tmp.FontInfo, codepoint))
+                src_tmp.GlyphsSet.SetBit(codepoint);
+}
+
+static void ImFontAtlasBuildUnpackGlyphsJob(void* data, int src_i)
+{
+    ImFontBuildSrcData& src_tmp = ((ImFontBuildJobData*)data)->SrcData[src_i];
+    UnpackBitVectorToFlatIndexList(&src_tmp.GlyphsSet, &src_tmp.GlyphsList);
+    IM_ASSERT(src_tmp.GlyphsList.Size == src_tmp.GlyphsCount);
+}
+
+// Gather the sizes of all rectangles we will need to pack (this is based on stbtt_PackFontRangesGatherRects)
+static void ImFontAtlasBuildGatherRectsJob(void* data, int src_i)
+{
+    ImFontAtlas* atlas = ((ImFontBuildJobData*)data)->Atlas;
+    ImFontBuildSrcData& src_tmp = ((ImFontBuildJobData*)data)->SrcData[src_i];
+    if (src_tmp.GlyphsCount == 0)
+        return;
+    ImFontConfig& cfg = atlas->ConfigData[src_i];
+    const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
+    const int padding = atlas->TexGlyphPadding;
+    const int oversample_h = src_tmp.PackRange.h_oversample, oversample_v = src_tmp.PackRange.v_oversample;
+    const int sdf_padding = (atlas->Flags & ImFontAtlasFlags_SignedDistanceField) ? atlas->TexSdfPadding : 0;
+    for (int glyph_i = 0; glyph_i < src_tmp.GlyphsList.Size; glyph_i++)
+    {
+        int x0, y0, x1, y1;
+        const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
+        IM_ASSERT(glyph_index_in_font != 0);
+        stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, scale * oversample_h, scale * oversample_v, 0, 0, &x0, &y0, &x1, &y1);
+        if (sdf_padding > 0 && x0 != x1 && y0 != y1)
+        {
+            // Distance field around the glyph (empty glyphs have no field, see stbtt_GetGlyphSDF)
+            x1 += sdf_padding * 2;
+            y1 += sdf_padding * 2;
+        }
+        src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + oversample_h - 1);
+        src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + oversample_v - 1);
+    }
+}
+
+// Render signed distance fields of the glyphs into their rectangles and setup packed chars the same way as stbtt_PackFontRangesRenderIntoRects does (without oversampling)
+static void ImFontAtlasBuildRenderGlyphsSDF(ImFontAtlas* atlas, ImFontBuildSrcData& src_tmp)
+{
+    const float scale = (src_tmp.PackRange.font_size > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, src_tmp.PackRange.font_size) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -src_tmp.PackRange.font_size);
+    const int sdf_padding = atlas->TexSdfPadding;
+    for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
+    {
+        const stbrp_rect& r = src_tmp.Rects[glyph_i];
+        stbtt_packedchar& bc = src_tmp.PackedChars[glyph_i];
+        if (!r.was_packed)
+            continue;
+        const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
+        int advance, lsb, w = 0, h = 0, x0 = 0, y0 = 0;
+        stbtt_GetGlyphHMetrics(&src_tmp.FontInfo, glyph_index_in_font, &advance, &lsb);
+        if (unsigned char* sdf = stbtt_GetGlyphSDF(&src_tmp.FontInfo, scale, glyph_index_in_font, sdf_padding, IM_FONT_SDF_ONEDGE_VALUE, IM_FONT_SDF_PIXEL_DIST_SCALE(sdf_padding), &w, &h, &x0, &y0))
+        {
+            IM_ASSERT(w <= r.w && h <= r.h);
+            for (int y = 0; y < h; y++)
+                memcpy(atlas->TexPixelsAlpha8 + (r.y + y) * atlas->TexWidth + r.x, sdf + y * w, (size_t)w);
+            stbtt_FreeSDF(sdf, src_tmp.FontInfo.userdata);
+        }
+        bc.x0 = (unsigned short)r.x;
+        bc.y0 = (unsigned short)r.y;
+        bc.x1 = (unsigned short)(r.x + w);
+        bc.y1 = (unsigned short)(r.y + h);
+        bc.xadvance = scale * advance;
+        bc.xoff = (float)x0;
+        bc.yoff = (float)y0;
+        bc.xoff2 = (float)(x0 + w);
+        bc.yoff2 = (float)(y0 + h);
+    }
+}
+
+// Render/rasterize font characters into their rectangles of the texture
+static void ImFontAtlasBuildRenderGlyphsJob(void* data, int src_i)
+{
+    ImFontAtlas* atlas = ((ImFontBuildJobData*)data)->Atlas;
+    ImFontBuildSrcData& src_tmp = ((ImFontBuildJobData*)data)->SrcData[src_i];
+    if (src_tmp.GlyphsCount == 0)
+        return;
+
+    if (atlas->Flags & ImFontAtlasFlags_SignedDistanceField)
+    {
+        ImFontAtlasBuildRenderGlyphsSDF(atlas, src_tmp);
+        return;
+    }
+
+    // Each source uses own copy of the packing context (oversampling settings are stored in it while rendering)
+    ImFontConfig& cfg = atlas->ConfigData[src_i];
+    stbtt_pack_context spc = *((ImFontBuildJobData*)data)->PackContext;
+    stbtt_PackFontRangesRenderIntoRects(&spc, &src_tmp.FontInfo, &src_tmp.PackRange, 1, src_tmp.Rects);
+
+    // Apply multiply operator
+    if (cfg.RasterizerMultiply != 1.0f)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        stbrp_rect* r = &src_tmp.Rects[0];
+        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++, r++)
+            if (r->was_packed)
+                ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
+    }
+}
+
 static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
+    IM_ASSERT(!(atlas->Flags & ImFontAtlasFlags_SignedDistanceField) || atlas->TexSdfPadding > 0);
+
+    // Baked lines texture can't be decoded as a signed distance field
+    if (atlas->Flags & ImFontAtlasFlags_SignedDistanceField)
+        atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
 
     ImFontAtlasBuildInit(atlas);
 
     // Clear atlas
     atlas->TexID = (ImTextureID)NULL;
     atlas->TexWidth = atlas->TexHeight = 0;
+    atlas->TexOccupancy = 0.0f;
     atlas->TexUvScale = ImVec2(0.0f, 0.0f);
     atlas->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
     atlas->ClearTexData();
@@ -2447,42 +2807,39 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         dst_tmp.GlyphsHighest = ImMax(dst_tmp.GlyphsHighest, src_tmp.GlyphsHighest);
     }
 
-    // 2. For every requested codepoint, check for their presence in the font data, and handle redundancy or overlaps between source fonts to avoid unused glyphs.
+    // 2. For every requested codepoint, check for their presence in the font data (for all source fonts in parallel)
+    ImFontBuildJobData job_data = { atlas, src_tmp_array.Data, NULL };
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+        src_tmp_array[src_i].GlyphsSet.Create(src_tmp_array[src_i].GlyphsHighest + 1);
+    ImFontAtlasBuildParallelFor(&job_data, ImFontAtlasBuildFindGlyphsJob);
+
+    // Handle redundancy or overlaps between source fonts to avoid unused glyphs (earlier source font wins)
     int total_glyphs_count = 0;
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
     {
         ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
         ImFontBuildDstData& dst_tmp = dst_tmp_array[src_tmp.DstIndex];
-        src_tmp.GlyphsSet.Create(src_tmp.GlyphsHighest + 1);
         if (dst_tmp.GlyphsSet.Storage.empty())
             dst_tmp.GlyphsSet.Create(dst_tmp.GlyphsHighest + 1);
 
-        for (const ImWchar* src_range = src_tmp.SrcRanges; src_range[0] && src_range[1]; src_range += 2)
-            for (unsigned int codepoint = src_range[0]; codepoint <= src_range[1]; codepoint++)
-            {
-                if (dst_tmp.GlyphsSet.TestBit(codepoint))    // Don't overwrite existing glyphs. We could make this an option for MergeMode (e.g. MergeOverwrite==true)
-                    continue;
-                if (!stbtt_FindGlyphIndex(&src_tmp.FontInfo, codepoint))    // It is actually in the font?
-                    continue;
-
-                // Add to avail set/counters
-                src_tmp.GlyphsCount++;
-                dst_tmp.GlyphsCount++;
-                src_tmp.GlyphsSet.SetBit(codepoint);
-                dst_tmp.GlyphsSet.SetBit(codepoint);
-                total_glyphs_count++;
-            }
+        // Don't overwrite existing glyphs. We could make this an option for MergeMode (e.g. MergeOverwrite==true)
+        for (int word_i = 0; word_i < src_tmp.GlyphsSet.Storage.Size; word_i++)
+        {
+            const ImU32 entries_32 = src_tmp.GlyphsSet.Storage[word_i] & ~dst_tmp.GlyphsSet.Storage[word_i];
+            src_tmp.GlyphsSet.Storage[word_i] = entries_32;
+            dst_tmp.GlyphsSet.Storage[word_i] |= entries_32;
+            src_tmp.GlyphsCount += ImFontAtlasBuildCountBits(entries_32);
+        }
+        dst_tmp.GlyphsCount += src_tmp.GlyphsCount;
+        total_glyphs_count += src_tmp.GlyphsCount;
     }
 
     // 3. Unpack our bit map into a flat list (we now have all the Unicode points that we know are requested _and_ available _and_ not overlapping another)
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        src_tmp.GlyphsList.reserve(src_tmp.GlyphsCount);
-        UnpackBitVectorToFlatIndexList(&src_tmp.GlyphsSet, &src_tmp.GlyphsList);
-        src_tmp.GlyphsSet.Clear();
-        IM_ASSERT(src_tmp.GlyphsList.Size == src_tmp.GlyphsCount);
-    }
+        src_tmp_array[src_i].GlyphsList.reserve(src_tmp_array[src_i].GlyphsCount);
+    ImFontAtlasBuildParallelFor(&job_data, ImFontAtlasBuildUnpackGlyphsJob);
+    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
+        src_tmp_array[src_i].GlyphsSet.Clear();
     for (int dst_i = 0; dst_i < dst_tmp_array.Size; dst_i++)
         dst_tmp_array[dst_i].GlyphsSet.Clear();
     dst_tmp_array.clear();
@@ -2518,24 +2875,15 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         src_tmp.PackRange.array_of_unicode_codepoints = src_tmp.GlyphsList.Data;
         src_tmp.PackRange.num_chars = src_tmp.GlyphsList.Size;
         src_tmp.PackRange.chardata_for_range = src_tmp.PackedChars;
-        src_tmp.PackRange.h_oversample = (unsigned char)cfg.OversampleH;
-        src_tmp.PackRange.v_oversample = (unsigned char)cfg.OversampleV;
-
-        // Gather the sizes of all rectangles we will need to pack (this loop is based on stbtt_PackFontRangesGatherRects)
-        const float scale = (cfg.SizePixels > 0) ? stbtt_ScaleForPixelHeight(&src_tmp.FontInfo, cfg.SizePixels) : stbtt_ScaleForMappingEmToPixels(&src_tmp.FontInfo, -cfg.SizePixels);
-        const int padding = atlas->TexGlyphPadding;
-        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsList.Size; glyph_i++)
-        {
-            int x0, y0, x1, y1;
-            const int glyph_index_in_font = stbtt_FindGlyphIndex(&src_tmp.FontInfo, src_tmp.GlyphsList[glyph_i]);
-            IM_ASSERT(glyph_index_in_font != 0);
-            stbtt_GetGlyphBitmapBoxSubpixel(&src_tmp.FontInfo, glyph_index_in_font, scale * cfg.OversampleH, scale * cfg.OversampleV, 0, 0, &x0, &y0, &x1, &y1);
-            src_tmp.Rects[glyph_i].w = (stbrp_coord)(x1 - x0 + padding + cfg.OversampleH - 1);
-            src_tmp.Rects[glyph_i].h = (stbrp_coord)(y1 - y0 + padding + cfg.OversampleV - 1);
-            total_surface += src_tmp.Rects[glyph_i].w * src_tmp.Rects[glyph_i].h;
-        }
+        src_tmp.PackRange.h_oversample = (atlas->Flags & ImFontAtlasFlags_SignedDistanceField) ? 1 : (unsigned char)cfg.OversampleH;
+        src_tmp.PackRange.v_oversample = (atlas->Flags & ImFontAtlasFlags_SignedDistanceField) ? 1 : (unsigned char)cfg.OversampleV;
     }
 
+    // Gather the sizes of all rectangles we will need to pack (for all source fonts in parallel)
+    ImFontAtlasBuildParallelFor(&job_data, ImFontAtlasBuildGatherRectsJob);
+    for (int rect_i = 0; rect_i < buf_rects_out_n; rect_i++)
+        total_surface += buf_rects[rect_i].w * buf_rects[rect_i].h;
+
     // We need a width for the skyline algorithm, any width!
     // The exact width doesn't really matter much, but some API/GPU have texture size limitations and increasing width can decrease height.
     // User can override TexDesiredWidth and TexGlyphPadding if they wish, otherwise we use a simple heuristic to select the width based on expected surface.
@@ -2551,54 +2899,44 @@ static bool ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     const int TEX_HEIGHT_MAX = 1024 * 32;
     stbtt_pack_context spc = {};
     stbtt_PackBegin(&spc, NULL, atlas->TexWidth, TEX_HEIGHT_MAX, 0, atlas->TexGlyphPadding, NULL);
+    const bool pack_best_fit = (atlas->Flags & ImFontAtlasFlags_PackBestFit) != 0;
+    if (atlas->Flags & ImFontAtlasFlags_PackSortByArea)
+        stbrp_setup_heuristic((stbrp_context*)spc.pack_info, pack_best_fit ? STBRP_HEURISTIC_Skyline_BF_sortArea : STBRP_HEURISTIC_Skyline_BL_sortArea);
+    else
+        stbrp_setup_heuristic((stbrp_context*)spc.pack_info, pack_best_fit ? STBRP_HEURISTIC_Skyline_BF_sortHeight : STBRP_HEURISTIC_Skyline_BL_sortHeight);
     ImFontAtlasBuildPackCustomRects(atlas, spc.pack_info);
 
-    // 6. Pack each source font. No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
-    for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbrp_pack_rects((stbrp_context*)spc.pack_info, src_tmp.Rects, src_tmp.GlyphsCount);
+    // 6. Pack glyphs of all source fonts at once (sorted together they leave less gaps than packed font by font). No rendering yet, we are working with rectangles in an infinitely tall texture at this point.
+    if (buf_rects_out_n > 0)
+        stbrp_pack_rects((stbrp_context*)spc.pack_info, buf_rects.Data, buf_rects_out_n);
 
-        // Extend texture height and mark missing glyphs as non-packed so we won't render them.
-        // FIXME: We are not handling packing failure here (would happen if we got off TEX_HEIGHT_MAX or if a single if larger than TexWidth?)
-        for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++)
-            if (src_tmp.Rects[glyph_i].was_packed)
-                atlas->TexHeight = ImMax(atlas->TexHeight, src_tmp.Rects[glyph_i].y + src_tmp.Rects[glyph_i].h);
-    }
+    // Extend texture height and mark missing glyphs as non-packed so we won't render them.
+    // FIXME: We are not handling packing failure here (would happen if we got off TEX_HEIGHT_MAX or if a single if larger than TexWidth?)
+    int packed_surface = 0;
+    for (int rect_i = 0; rect_i < buf_rects_out_n; rect_i++)
+        if (buf_rects[rect_i].was_packed)
+        {
+            atlas->TexHeight = ImMax(atlas->TexHeight, buf_rects[rect_i].y + buf_rects[rect_i].h);
+            packed_surface += buf_rects[rect_i].w * buf_rects[rect_i].h;
+        }
+    for (int rect_i = 0; rect_i < atlas->CustomRects.Size; rect_i++)
+        if (atlas->CustomRects[rect_i].IsPacked())
+            packed_surface += atlas->CustomRects[rect_i].Width * atlas->CustomRects[rect_i].Height;
 
     // 7. Allocate texture
     atlas->TexHeight = (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight) ? (atlas->TexHeight + 1) : ImUpperPowerOfTwo(atlas->TexHeight);
+    atlas->TexOccupancy = (float)packed_surface / (float)(atlas->TexWidth * atlas->TexHeight);
     atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
     atlas->TexPixelsAlpha8 = (unsigned char*)IM_ALLOC(atlas->TexWidth * atlas->TexHeight);
     memset(atlas->TexPixelsAlpha8, 0, atlas->TexWidth * atlas->TexHeight);
     spc.pixels = atlas->TexPixelsAlpha8;
     spc.height = atlas->TexHeight;
 
-    // 8. Render/rasterize font characters into the texture
+    // 8. Render/rasterize font characters into the texture (for all source fonts in parallel, glyph rectangles don't overlap)
+    job_data.PackContext = &spc;
+    ImFontAtlasBuildParallelFor(&job_data, ImFontAtlasBuildRenderGlyphsJob);
     for (int src_i = 0; src_i < src_tmp_array.Size; src_i++)
-    {
-        ImFontConfig& cfg = atlas->ConfigData[src_i];
-        ImFontBuildSrcData& src_tmp = src_tmp_array[src_i];
-        if (src_tmp.GlyphsCount == 0)
-            continue;
-
-        stbtt_PackFontRangesRenderIntoRects(&spc, &src_tmp.FontInfo, &src_tmp.PackRange, 1, src_tmp.Rects);
-
-        // Apply multiply operator
-        if (cfg.RasterizerMultiply != 1.0f)
-        {
-            unsigned char multiply_table[256];
-            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
-            stbrp_rect* r = &src_tmp.Rects[0];
-            for (int glyph_i = 0; glyph_i < src_tmp.GlyphsCount; glyph_i++, r++)
-                if (r->was_packed)
-                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, r->x, r->y, r->w, r->h, atlas->TexWidth * 1);
-        }
-        src_tmp.Rects = NULL;
-    }
+        src_tmp_array[src_i].Rects = NULL;
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -3183,6 +3521,7 @@ ImFont::ImFont()
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
     memset(Used4kPagesMap, 0, sizeof(Used4kPagesMap));
+    DynamicGlyphsStart = INT_MAX;
 }
 
 ImFont::~ImFont()
@@ -3192,16 +3531,20 @@ ImFont::~ImFont()
 
 void    ImFont::ClearOutputData()
 {
+    if (ContainerAtlas)
+        ContainerAtlas->GlyphsVersion++;
     FontSize = 0.0f;
     FallbackAdvanceX = 0.0f;
     Glyphs.clear();
-    IndexAdvanceX.clear();
-    IndexLookup.clear();
+    IndexPageMap.clear();
+    IndexPages.clear();
     FallbackGlyph = NULL;
     ContainerAtlas = NULL;
     DirtyLookupTables = true;
     Ascent = Descent = 0.0f;
     MetricsTotalSurface = 0;
+    DynamicGlyphsStart = INT_MAX;
+    DynamicGlyphsLastUse.clear();
 }
 
 static ImWchar FindFirstExistingGlyph(ImFont* font, const ImWchar* candidate_chars, int candidate_chars_count)
@@ -3220,16 +3563,15 @@ void ImFont::BuildLookupTable()
 
     // Build lookup table
     IM_ASSERT(Glyphs.Size < 0xFFFF); // -1 is reserved
-    IndexAdvanceX.clear();
-    IndexLookup.clear();
+    IndexPageMap.clear();
+    IndexPages.clear();
     DirtyLookupTables = false;
     memset(Used4kPagesMap, 0, sizeof(Used4kPagesMap));
     GrowIndex(max_codepoint + 1);
     for (int i = 0; i < Glyphs.Size; i++)
     {
         int codepoint = (int)Glyphs[i].Codepoint;
-        IndexAdvanceX[codepoint] = Glyphs[i].AdvanceX;
-        IndexLookup[codepoint] = (ImWchar)i;
+        SetGlyphIndex((ImWchar)codepoint, (ImWchar)i, Glyphs[i].AdvanceX);
 
         // Mark 4K page as used
         const int page_n = codepoint / 4096;
@@ -3246,8 +3588,7 @@ void ImFont::BuildLookupTable()
         tab_glyph = *FindGlyph((ImWchar)' ');
         tab_glyph.Codepoint = '\t';
         tab_glyph.AdvanceX *= IM_TABSIZE;
-        IndexAdvanceX[(int)tab_glyph.Codepoint] = (float)tab_glyph.AdvanceX;
-        IndexLookup[(int)tab_glyph.Codepoint] = (ImWchar)(Glyphs.Size - 1);
+        SetGlyphIndex((ImWchar)tab_glyph.Codepoint, (ImWchar)(Glyphs.Size - 1), (float)tab_glyph.AdvanceX);
     }
 
     // Mark special glyphs as not visible (note that AddGlyph already mark as non-visible glyphs with zero-size polygons)
@@ -3268,9 +3609,10 @@ void ImFont::BuildLookupTable()
         }
     }
     FallbackAdvanceX = FallbackGlyph->AdvanceX;
-    for (int i = 0; i < max_codepoint + 1; i++)
-        if (IndexAdvanceX[i] < 0.0f)
-            IndexAdvanceX[i] = FallbackAdvanceX;
+    for (int page_n = 0; page_n < IndexPages.Size; page_n++) // Including the empty page (copied by pages allocated later)
+        for (int i = 0; i < IM_FONT_INDEX_PAGE_SIZE; i++)
+            if (IndexPages[page_n].AdvanceX[i] < 0.0f)
+                IndexPages[page_n].AdvanceX[i] = FallbackAdvanceX;
 
     // Setup Ellipsis character. It is required for rendering elided text. We prefer using U+2026 (horizontal ellipsis).
     // However some old fonts may contain ellipsis at U+0085. Here we auto-detect most suitable ellipsis character.
@@ -3314,13 +3656,40 @@ void ImFont::SetGlyphVisible(ImWchar c, bool visible)
         glyph->Visible = visible ? 1 : 0;
 }
 
+// Extend the pages map to new_size code points (new blocks point to the empty page)
 void ImFont::GrowIndex(int new_size)
 {
-    IM_ASSERT(IndexAdvanceX.Size == IndexLookup.Size);
-    if (new_size <= IndexLookup.Size)
-        return;
-    IndexAdvanceX.resize(new_size, -1.0f);
-    IndexLookup.resize(new_size, (ImWchar)-1);
+    if (IndexPages.Size == 0)
+    {
+        IndexPages.resize(1);
+        for (int i = 0; i < IM_FONT_INDEX_PAGE_SIZE; i++)
+        {
+            IndexPages[0].AdvanceX[i] = -1.0f;
+            IndexPages[0].Lookup[i] = (ImWchar)-1;
+        }
+    }
+    const int new_pages_count = (new_size + IM_FONT_INDEX_PAGE_SIZE - 1) / IM_FONT_INDEX_PAGE_SIZE;
+    if (new_pages_count > IndexPageMap.Size)
+        IndexPageMap.resize(new_pages_count, 0);
+}
+
+void ImFont::SetGlyphIndex(ImWchar c, ImWchar glyph_index, float advance_x)
+{
+    GrowIndex((int)c + 1);
+    ImU16& page_index = IndexPageMap[(unsigned int)c / IM_FONT_INDEX_PAGE_SIZE];
+    if (page_index == 0)
+    {
+        // Allocate the page for the block (copy of the empty page, which may be relocated by the push)
+        IM_ASSERT(IndexPages.Size <= 0xFFFF);
+        const ImFontIndexPage empty_page = IndexPages[0];
+        page_index = (ImU16)IndexPages.Size;
+        IndexPages.push_back(empty_page);
+    }
+    ImFontIndexPage& page = IndexPages[page_index];
+    page.Lookup[(unsigned int)c % IM_FONT_INDEX_PAGE_SIZE] = glyph_index;
+    page.AdvanceX[(unsigned int)c % IM_FONT_INDEX_PAGE_SIZE] = advance_x;
+    if (ContainerAtlas)
+        ContainerAtlas->GlyphsVersion++;
 }
 
 // x0/y0/x1/y1 are offset from the character upper-left layout position, in pixels. Therefore x0/y0 are often fairly close to zero.
@@ -3372,39 +3741,59 @@ void ImFont::AddGlyph(const ImFontConfig* cfg, ImWchar codepoint, float x0, floa
 
 void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
 {
-    IM_ASSERT(IndexLookup.Size > 0);    // Currently this can only be called AFTER the font has been built, aka after calling ImFontAtlas::GetTexDataAs*() function.
-    unsigned int index_size = (unsigned int)IndexLookup.Size;
+    IM_ASSERT(IndexPageMap.Size > 0);    // Currently this can only be called AFTER the font has been built, aka after calling ImFontAtlas::GetTexDataAs*() function.
+    unsigned int index_size = (unsigned int)IndexPageMap.Size * IM_FONT_INDEX_PAGE_SIZE;
 
-    if (dst < index_size && IndexLookup.Data[dst] == (ImWchar)-1 && !overwrite_dst) // 'dst' already exists
+    if (dst < index_size && GetGlyphIndex(dst) == (ImWchar)-1 && !overwrite_dst) // 'dst' already exists
         return;
     if (src >= index_size && dst >= index_size) // both 'dst' and 'src' don't exist -> no-op
         return;
 
-    GrowIndex(dst + 1);
-    IndexLookup[dst] = (src < index_size) ? IndexLookup.Data[src] : (ImWchar)-1;
-    IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
+    SetGlyphIndex(dst, (src < index_size) ? GetGlyphIndex(src) : (ImWchar)-1, (src < index_size) ? GetCharAdvance(src) : 1.0f);
 }
 
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
 {
-    if (c >= (size_t)IndexLookup.Size)
-        return FallbackGlyph;
-    const ImWchar i = IndexLookup.Data[c];
+    const ImWchar i = GetGlyphIndex(c);
     if (i == (ImWchar)-1)
+    {
+        // Let the user add the glyph for the next frames (eg. rasterize it on demand)
+        if (ContainerAtlas && ContainerAtlas->GlyphMissingCallback)
+            ContainerAtlas->GlyphMissingCallback((ImFont*)this, c);
         return FallbackGlyph;
+    }
+    if ((int)i >= DynamicGlyphsStart)
+        DynamicGlyphsLastUse.Data[i - DynamicGlyphsStart] = ContainerAtlas->DynamicGlyphsFrame;
     return &Glyphs.Data[i];
 }
 
 const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
 {
-    if (c >= (size_t)IndexLookup.Size)
-        return NULL;
-    const ImWchar i = IndexLookup.Data[c];
+    const ImWchar i = GetGlyphIndex(c);
     if (i == (ImWchar)-1)
         return NULL;
     return &Glyphs.Data[i];
 }
 
+// Find the end of the run of printable ASCII characters (they need no UTF-8 decoding nor control characters handling), 16 bytes at a time with SSE
+static inline const char* FindPrintableAsciiRunEnd(const char* text, const char* text_end)
+{
+#ifdef IMGUI_ENABLE_SSE
+    const __m128i first_printable = _mm_set1_epi8(0x20);
+    while (text_end - text >= 16)
+    {
+        // Bytes of UTF-8 sequences (>= 0x80) are negative so the signed comparison catches them with control characters
+        const __m128i chars = _mm_loadu_si128((const __m128i*)(const void*)text);
+        if (_mm_movemask_epi8(_mm_cmplt_epi8(chars, first_printable)) != 0)
+            break;
+        text += 16;
+    }
+#endif
+    while (text < text_end && (signed char)*text >= 0x20)
+        text++;
+    return text;
+}
+
 // Wrapping skips upcoming blanks
 static inline const char* CalcWordWrapNextLineStartA(const char* text, const char* text_end)
 {
@@ -3418,7 +3807,7 @@ static inline const char* CalcWordWrapNextLineStartA(const char* text, const cha
 // Simple word-wrapping for English, not full-featured. Please submit failing cases!
 // This will return the next location to wrap from. If no wrapping if necessary, this will fast-forward to e.g. text_end.
 // FIXME: Much possible improvements (don't cut things like "word !", "word!!!" but cut within "word,,,,", more sensible support for punctuations, support for Unicode punctuations, etc.)
-const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
+const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width, const char** out_scan_end) const
 {
     // For references, possible wrap point marked with ^
     //  "aaa bbb, ccc,ddd. eee   fff. ggg!"
@@ -3467,7 +3856,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
             }
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX);
+        const float char_width = GetCharAdvance((ImWchar)c);
         if (ImCharIsBlankW(c))
         {
             if (inside_word)
@@ -3500,6 +3889,9 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
         // We ignore blank width at the end of the line (they can be skipped)
         if (line_width + word_width > wrap_width)
         {
+            if (out_scan_end)
+                *out_scan_end = next_s;
+
             // Words that cannot possibly fit within an entire line will be cut anywhere.
             if (word_width < wrap_width)
                 s = prev_word_end ? prev_word_end : word_end;
@@ -3508,6 +3900,8 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
 
         s = next_s;
     }
+    if (out_scan_end && s >= text_end)
+        *out_scan_end = text_end;
 
     // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
     // +1 may not be a character start point in UTF-8 but it's ok because caller loops use (text >= word_wrap_eol).
@@ -3530,6 +3924,9 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
 
+    // Advances of the printable ASCII characters (they are all in the first block of the glyphs index)
+    const float* ascii_advance = IndexPageMap.Size > 0 ? IndexPages.Data[IndexPageMap.Data[0]].AdvanceX : NULL;
+
     const char* s = text_begin;
     while (s < text_end)
     {
@@ -3551,6 +3948,22 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Accumulate advances of printable ASCII characters in a tight loop (same math as below)
+        if (ascii_advance != NULL && (signed char)*s >= 0x20)
+        {
+            const char* run_end = FindPrintableAsciiRunEnd(s, word_wrap_enabled ? word_wrap_eol : text_end);
+            for (; s < run_end; s++)
+            {
+                const float char_width = ascii_advance[(unsigned char)*s] * scale;
+                if (line_width + char_width >= max_width)
+                    break;
+                line_width += char_width;
+            }
+            if (s < run_end)
+                break;
+            continue;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -3572,7 +3985,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 continue;
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX) * scale;
+        const float char_width = GetCharAdvance((ImWchar)c) * scale;
         if (line_width + char_width >= max_width)
         {
             s = prev_s;
@@ -3676,6 +4089,10 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, Im
     const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
     const char* word_wrap_eol = NULL;
 
+    // Printable ASCII characters are looked up directly in the first block of the glyphs index (they are all in it)
+    const ImWchar* ascii_lookup = IndexPageMap.Size > 0 ? IndexPages.Data[IndexPageMap.Data[0]].Lookup : NULL;
+    const char* ascii_run_end = s;
+
     while (s < text_end)
     {
         if (word_wrap_enabled)
@@ -3694,28 +4111,41 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, Im
             }
         }
 
-        // Decode and advance source
-        unsigned int c = (unsigned int)*s;
-        if (c < 0x80)
-            s += 1;
+        // Runs of printable ASCII characters skip decoding and control characters handling
+        if (s >= ascii_run_end && ascii_lookup != NULL && (signed char)*s >= 0x20)
+            ascii_run_end = FindPrintableAsciiRunEnd(s, text_end);
+        const ImFontGlyph* glyph;
+        if (s < ascii_run_end)
+        {
+            const unsigned int c = (unsigned char)*s++;
+            const ImWchar glyph_index = ascii_lookup[c];
+            glyph = (glyph_index != (ImWchar)-1 && (int)glyph_index < DynamicGlyphsStart) ? &Glyphs.Data[glyph_index] : FindGlyph((ImWchar)c);
+        }
         else
-            s += ImTextCharFromUtf8(&c, s, text_end);
-
-        if (c < 32)
         {
-            if (c == '\n')
+            // Decode and advance source
+            unsigned int c = (unsigned int)*s;
+            if (c < 0x80)
+                s += 1;
+            else
+                s += ImTextCharFromUtf8(&c, s, text_end);
+
+            if (c < 32)
             {
-                x = start_x;
-                y += line_height;
-                if (y > clip_rect.w)
-                    break; // break out of main loop
-                continue;
+                if (c == '\n')
+                {
+                    x = start_x;
+                    y += line_height;
+                    if (y > clip_rect.w)
+                        break; // break out of main loop
+                    continue;
+                }
+                if (c == '\r')
+                    continue;
             }
-            if (c == '\r')
-                continue;
-        }
 
-        const ImFontGlyph* glyph = FindGlyph((ImWchar)c);
+            glyph = FindGlyph((ImWchar)c);
+        }
         if (glyph == NULL)
             continue;
 
@@ -328,6 +328,8 @@ namespace ImStb
 // - Helper: ImPool<>
 // - Helper: ImChunkStream<>
 // - Helper: ImGuiTextIndex
+// - Helper: ImGuiTextSizeCache
+// - Helper: ImGuiTextLayoutCache
 //-----------------------------------------------------------------------------
 
 // Helpers: Hashing
@@ -717,6 +719,69 @@ struct ImGuiTextIndex
     void            append(const char* base, int old_size, int new_size);
 };
 
+// Helper: ImGuiTextSizeCache
+// Sizes returned by CalcTextSize() in the last frames (see io.ConfigTextSizeCache). Open addressing hash table (linear probing) keyed by the 64-bit hash of the font, font size, wrap width and text.
+// Entries store the frame of their last use (generation): the ones not used in the current or previous frame are evicted when the table gets half full.
+struct ImGuiTextSizeCacheEntry
+{
+    ImU64           Key;                                    // 0 = empty slot
+    int             TextLen;
+    int             LastFrame;
+    ImVec2          Size;
+};
+
+struct ImGuiTextSizeCache
+{
+    ImVector<ImGuiTextSizeCacheEntry> Entries;              // Power of two size
+    int             EntriesCount = 0;
+    ImFontAtlas*    FontAtlas = NULL;                       // Atlas of the cached sizes (everything is dropped when io.Fonts changes)
+    int             Hits = 0, Misses = 0;                   // Lookups in the current frame
+    int             HitsLastFrame = 0, MissesLastFrame = 0;
+
+    void            clear()                                 { if (Entries.Size > 0) memset(Entries.Data, 0, (size_t)Entries.size_in_bytes()); EntriesCount = 0; }
+    void            clear_free_memory()                     { Entries.clear(); EntriesCount = 0; FontAtlas = NULL; }
+};
+
+// Helper: ImGuiTextLayoutCache
+// Line breaks of wrapped texts built in the last frames (see io.ConfigTextLayoutCache), so TextWrapped() doesn't wrap the whole text every frame and only renders the visible lines.
+// Layouts are keyed by the 64-bit hash of the font, font size, wrap width and text. The layout last built from each text pointer is also tracked: when the text changed
+// but still starts with the same contents (eg. log with lines appended or text edited at the end), only the lines which breaks depend on the changed text are broken again.
+struct ImGuiTextLayoutLine
+{
+    int             Offset;                                 // Start of the line in the text
+    int             End;                                    // End of the line contents (before the line feed or the blanks skipped by wrapping)
+    int             ScanEnd;                                // End of the text read to find where the line ends (past the text end when the text end was reached)
+    float           Y;                                      // Height of the text before the line
+    float           MaxWidth;                               // Width of the widest line before this one
+};
+
+struct ImGuiTextLayout
+{
+    ImU64           Key;
+    ImU64           PrefixHash;                             // Hash of the text read to break the lines before RestartLine (they stay the same for any text starting with it)
+    int             PrefixLen;
+    int             RestartLine;                            // Line to break the text again from when only the text past the prefix changed
+    int             TextLen;
+    int             LastFrame;
+    ImVec2          Size;                                   // Same as CalcTextSize() with the wrap width
+    ImVector<ImGuiTextLayoutLine> Lines;
+
+    ImGuiTextLayout()                                       { memset(this, 0, sizeof(*this)); }
+};
+
+struct ImGuiTextLayoutCache
+{
+    ImPool<ImGuiTextLayout> Layouts;                        // Keyed by the 32-bit fold of the layout key
+    ImGuiStorage    SourceLayouts;                          // Key of the layout last built from each text pointer (with the font, font size and wrap width)
+    ImVector<ImGuiTextLayoutLine> TempLines;
+    ImFontAtlas*    FontAtlas = NULL;                       // Atlas of the cached layouts (everything is dropped when io.Fonts changes)
+    int             Hits = 0, Misses = 0, IncrementalMisses = 0;  // Lookups in the current frame (incremental misses only broke the last lines again)
+    int             HitsLastFrame = 0, MissesLastFrame = 0, IncrementalMissesLastFrame = 0;
+
+    void            clear()                                 { Layouts.Clear(); SourceLayouts.Clear(); }
+    void            clear_free_memory()                     { clear(); TempLines.clear(); FontAtlas = NULL; }
+};
+
 //-----------------------------------------------------------------------------
 // [SECTION] ImDrawList support
 //-----------------------------------------------------------------------------
@@ -2071,6 +2136,8 @@ struct ImGuiContext
     int                     WantCaptureKeyboardNextFrame;       // "
     int                     WantTextInputNextFrame;
     ImVector<char>          TempBuffer;                         // Temporary text buffer
+    ImGuiTextSizeCache      TextSizeCache;                      // Sizes returned by CalcTextSize() in the last frames (when io.ConfigTextSizeCache is enabled)
+    ImGuiTextLayoutCache    TextLayoutCache;                    // Line breaks of wrapped texts in the last frames (when io.ConfigTextLayoutCache is enabled)
 
     ImGuiContext(ImFontAtlas* shared_font_atlas)
     {
@@ -2894,6 +2961,7 @@ namespace ImGui
     IMGUI_API void          SetLastItemData(ImGuiID item_id, ImGuiItemFlags in_flags, ImGuiItemStatusFlags status_flags, const ImRect& item_rect);
     IMGUI_API ImVec2        CalcItemSize(ImVec2 size, float default_w, float default_h);
     IMGUI_API float         CalcWrapWidthForPos(const ImVec2& pos, float wrap_pos_x);
+    IMGUI_API ImGuiTextLayout* GetTextLayout(const char* text, const char* text_end, float wrap_width); // Requires io.ConfigTextLayoutCache. Valid until the next call.
     IMGUI_API void          PushMultiItemsWidths(int components, float width_full);
     IMGUI_API bool          IsItemToggledSelection();                                   // Was the last item selection toggled? (after Selectable(), TreeNode() etc. We only returns toggle _event_ in order to handle clipping correctly)
     IMGUI_API ImVec2        GetContentRegionMaxAbs();
@@ -3148,6 +3216,7 @@ namespace ImGui
     // NB: All position are in absolute pixels coordinates (we are never using window coordinates internally)
     IMGUI_API void          RenderText(ImVec2 pos, const char* text, const char* text_end = NULL, bool hide_text_after_hash = true);
     IMGUI_API void          RenderTextWrapped(ImVec2 pos, const char* text, const char* text_end, float wrap_width);
+    IMGUI_API void          RenderTextLayout(ImVec2 pos, const char* text, const ImGuiTextLayout* layout);
     IMGUI_API void          RenderTextClipped(const ImVec2& pos_min, const ImVec2& pos_max, const char* text, const char* text_end, const ImVec2* text_size_if_known, const ImVec2& align = ImVec2(0, 0), const ImRect* clip_rect = NULL);
     IMGUI_API void          RenderTextClippedEx(ImDrawList* draw_list, const ImVec2& pos_min, const ImVec2& pos_max, const char* text, const char* text_end, const ImVec2* text_size_if_known, const ImVec2& align = ImVec2(0, 0), const ImRect* clip_rect = NULL);
     IMGUI_API void          RenderTextEllipsis(ImDrawList* draw_list, const ImVec2& pos_min, const ImVec2& pos_max, float clip_max_x, float ellipsis_max_x, const char* text, const char* text_end, const ImVec2* text_size_if_known);
@@ -3317,6 +3386,10 @@ IMGUI_API void      ImFontAtlasBuildRender32bppRectFromString(ImFontAtlas* atlas
 IMGUI_API void      ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_multiply_factor);
 IMGUI_API void      ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsigned char* pixels, int x, int y, int w, int h, int stride);
 
+// Value of the glyph outline in ImFontAtlasFlags_SignedDistanceField atlas (distance of TexSdfPadding pixels is mapped to 0 or 255)
+#define IM_FONT_SDF_ONEDGE_VALUE            128
+#define IM_FONT_SDF_PIXEL_DIST_SCALE(_PAD)  ((float)IM_FONT_SDF_ONEDGE_VALUE / (float)(_PAD))
+
 //-----------------------------------------------------------------------------
 // [SECTION] Test Engine specific hooks (imgui_test_engine)
 //-----------------------------------------------------------------------------
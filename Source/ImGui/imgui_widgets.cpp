@@ -166,7 +166,10 @@ void ImGui::TextEx(const char* text, const char* text_end, ImGuiTextFlags flags)
     {
         // Common case
         const float wrap_width = wrap_enabled ? CalcWrapWidthForPos(window->DC.CursorPos, wrap_pos_x) : 0.0f;
-        const ImVec2 text_size = CalcTextSize(text_begin, text_end, false, wrap_width);
+        // Wrapped text uses the cached layout, except when the wrap width is too small to fit any character (which is broken differently per character)
+        const bool use_layout = wrap_enabled && text_begin != text_end && wrap_width >= g.FontSize * 2.0f && g.IO.ConfigTextLayoutCache && g.TextLayoutCache.FontAtlas != NULL;
+        const ImGuiTextLayout* layout = use_layout ? GetTextLayout(text_begin, text_end, wrap_width) : NULL;
+        const ImVec2 text_size = layout ? layout->Size : CalcTextSize(text_begin, text_end, false, wrap_width);
 
         ImRect bb(text_pos, text_pos + text_size);
         ItemSize(text_size, 0.0f);
@@ -174,7 +177,10 @@ void ImGui::TextEx(const char* text, const char* text_end, ImGuiTextFlags flags)
             return;
 
         // Render (we don't hide text after ## in this end-user function)
-        RenderTextWrapped(bb.Min, text_begin, text_end, wrap_width);
+        if (layout)
+            RenderTextLayout(bb.Min, text_begin, layout); // Only the visible lines
+        else
+            RenderTextWrapped(bb.Min, text_begin, text_end, wrap_width);
     }
     else
     {
@@ -4300,7 +4306,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         password_font->ContainerAtlas = g.Font->ContainerAtlas;
         password_font->FallbackGlyph = glyph;
         password_font->FallbackAdvanceX = glyph->AdvanceX;
-        IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
+        IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexPageMap.empty() && password_font->IndexPages.empty());
         PushFont(password_font);
     }
 
@@ -167,7 +167,9 @@ enum
 {
    STBRP_HEURISTIC_Skyline_default=0,
    STBRP_HEURISTIC_Skyline_BL_sortHeight = STBRP_HEURISTIC_Skyline_default,
-   STBRP_HEURISTIC_Skyline_BF_sortHeight
+   STBRP_HEURISTIC_Skyline_BF_sortHeight,
+   STBRP_HEURISTIC_Skyline_BL_sortArea, // [DEAR IMGUI] Added sorting by area
+   STBRP_HEURISTIC_Skyline_BF_sortArea
 };
 
 
@@ -230,11 +232,13 @@ enum
    STBRP__INIT_skyline = 1
 };
 
+#define STBRP__BEST_FIT(heuristic) ((heuristic) == STBRP_HEURISTIC_Skyline_BF_sortHeight || (heuristic) == STBRP_HEURISTIC_Skyline_BF_sortArea) // [DEAR IMGUI]
+
 STBRP_DEF void stbrp_setup_heuristic(stbrp_context *context, int heuristic)
 {
    switch (context->init_mode) {
       case STBRP__INIT_skyline:
-         STBRP_ASSERT(heuristic == STBRP_HEURISTIC_Skyline_BL_sortHeight || heuristic == STBRP_HEURISTIC_Skyline_BF_sortHeight);
+         STBRP_ASSERT(heuristic >= STBRP_HEURISTIC_Skyline_BL_sortHeight && heuristic <= STBRP_HEURISTIC_Skyline_BF_sortArea); // [DEAR IMGUI]
          context->heuristic = heuristic;
          break;
       default:
@@ -367,7 +371,7 @@ static stbrp__findresult stbrp__skyline_find_best_pos(stbrp_context *c, int widt
    while (node->x + width <= c->width) {
       int y,waste;
       y = stbrp__skyline_find_min_y(c, node, node->x, width, &waste);
-      if (c->heuristic == STBRP_HEURISTIC_Skyline_BL_sortHeight) { // actually just want to test BL
+      if (!STBRP__BEST_FIT(c->heuristic)) { // actually just want to test BL [DEAR IMGUI]
          // bottom left
          if (y < best_y) {
             best_y = y;
@@ -407,7 +411,7 @@ static stbrp__findresult stbrp__skyline_find_best_pos(stbrp_context *c, int widt
    //
    // This makes BF take about 2x the time
 
-   if (c->heuristic == STBRP_HEURISTIC_Skyline_BF_sortHeight) {
+   if (STBRP__BEST_FIT(c->heuristic)) { // [DEAR IMGUI]
       tail = c->active_head;
       node = c->active_head;
       prev = &c->active_head;
@@ -536,6 +540,19 @@ static int STBRP__CDECL rect_height_compare(const void *a, const void *b)
    return (p->w > q->w) ? -1 : (p->w < q->w);
 }
 
+// [DEAR IMGUI] Added sorting by area
+static int STBRP__CDECL rect_area_compare(const void *a, const void *b)
+{
+   const stbrp_rect *p = (const stbrp_rect *) a;
+   const stbrp_rect *q = (const stbrp_rect *) b;
+   const int pa = p->w * p->h, qa = q->w * q->h;
+   if (pa > qa)
+      return -1;
+   if (pa < qa)
+      return  1;
+   return rect_height_compare(a, b);
+}
+
 static int STBRP__CDECL rect_original_order(const void *a, const void *b)
 {
    const stbrp_rect *p = (const stbrp_rect *) a;
@@ -553,7 +570,10 @@ STBRP_DEF int stbrp_pack_rects(stbrp_context *context, stbrp_rect *rects, int nu
    }
 
    // sort according to heuristic
-   STBRP_SORT(rects, num_rects, sizeof(rects[0]), rect_height_compare);
+   if (context->heuristic == STBRP_HEURISTIC_Skyline_BL_sortArea || context->heuristic == STBRP_HEURISTIC_Skyline_BF_sortArea) // [DEAR IMGUI]
+      STBRP_SORT(rects, num_rects, sizeof(rects[0]), rect_area_compare);
+   else
+      STBRP_SORT(rects, num_rects, sizeof(rects[0]), rect_height_compare);
 
    for (i=0; i < num_rects; ++i) {
       if (rects[i].w == 0 || rects[i].h == 0) {
@@ -1124,6 +1124,13 @@ typedef int stbtt__test_oversample_pow2[(STBTT_MAX_OVERSAMPLE & (STBTT_MAX_OVERS
 #define STBTT_RASTERIZER_VERSION 2
 #endif
 
+// [DEAR IMGUI] Optional vectorized rasterizer paths (define STBTT_SSE2 or STBTT_NEON), output is the same as the scalar code
+#if defined(STBTT_SSE2)
+#include <emmintrin.h>
+#elif defined(STBTT_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifdef _MSC_VER
 #define STBTT__NOTUSED(v)  (void)(v)
 #else
@@ -3301,6 +3308,40 @@ static void stbtt__fill_active_edges_new(float *scanline, float *scanline_fill,
    }
 }
 
+#if defined(STBTT_SSE2) || defined(STBTT_NEON)
+// [DEAR IMGUI] Converts accumulated coverage (area + running sum) of the scanline into pixels, 4 at a time. Returns the amount of processed pixels.
+static int stbtt__accumulate_coverage_simd(unsigned char *pixels, const float *scanline, const float *sums, int w)
+{
+   int i = 0;
+#if defined(STBTT_SSE2)
+   const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+   const __m128 scale = _mm_set1_ps(255.0f);
+   const __m128 bias = _mm_set1_ps(0.5f);
+   for (; i + 4 <= w; i += 4) {
+      __m128 k = _mm_add_ps(_mm_loadu_ps(scanline + i), _mm_loadu_ps(sums + i));
+      k = _mm_add_ps(_mm_mul_ps(_mm_and_ps(k, abs_mask), scale), bias);
+      __m128i m = _mm_cvttps_epi32(_mm_min_ps(k, scale));
+      m = _mm_packs_epi32(m, m);
+      m = _mm_packus_epi16(m, m);
+      int packed = _mm_cvtsi128_si32(m);
+      STBTT_memcpy(pixels + i, &packed, 4);
+   }
+#else
+   const float32x4_t scale = vdupq_n_f32(255.0f);
+   const float32x4_t bias = vdupq_n_f32(0.5f);
+   for (; i + 4 <= w; i += 4) {
+      float32x4_t k = vaddq_f32(vld1q_f32(scanline + i), vld1q_f32(sums + i));
+      k = vaddq_f32(vmulq_f32(vabsq_f32(k), scale), bias);
+      uint32x4_t m = vcvtq_u32_f32(vminq_f32(k, scale));
+      uint8x8_t m8 = vmovn_u16(vcombine_u16(vmovn_u32(m), vmovn_u32(m)));
+      uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(m8), 0);
+      STBTT_memcpy(pixels + i, &packed, 4);
+   }
+#endif
+   return i;
+}
+#endif
+
 // directly AA rasterize edges w/o supersampling
 static void stbtt__rasterize_sorted_edges(stbtt__bitmap *result, stbtt__edge *e, int n, int vsubsample, int off_x, int off_y, void *userdata)
 {
@@ -3370,6 +3411,24 @@ static void stbtt__rasterize_sorted_edges(stbtt__bitmap *result, stbtt__edge *e,
 
       {
          float sum = 0;
+#if defined(STBTT_SSE2) || defined(STBTT_NEON)
+         // [DEAR IMGUI] Vectorized coverage accumulation. Running sum is still added serially (same rounding as the scalar loop),
+         // conversion of the coverage into 8-bit pixels is done for 4 pixels at once.
+         for (i=0; i < result->w; ++i) {
+            sum += scanline2[i];
+            scanline2[i] = sum;
+         }
+         i = stbtt__accumulate_coverage_simd(result->pixels + j*result->stride, scanline, scanline2, result->w);
+         for (; i < result->w; ++i) {
+            float k;
+            int m;
+            k = scanline[i] + scanline2[i];
+            k = (float) STBTT_fabs(k)*255 + 0.5f;
+            m = (int) k;
+            if (m > 255) m = 255;
+            result->pixels[j*result->stride + i] = (unsigned char) m;
+         }
+#else
          for (i=0; i < result->w; ++i) {
             float k;
             int m;
@@ -3380,6 +3439,7 @@ static void stbtt__rasterize_sorted_edges(stbtt__bitmap *result, stbtt__edge *e,
             if (m > 255) m = 255;
             result->pixels[j*result->stride + i] = (unsigned char) m;
          }
+#endif
       }
       // advance all the edges
       step = &active;
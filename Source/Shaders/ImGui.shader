@@ -0,0 +1,73 @@
+// Copyright (c) Wojciech Figat. All rights reserved.
+
+#include "./Flax/Common.hlsl"
+
+META_CB_BEGIN(0, Data)
+float4x4 ViewProjection;
+float FontSDF;
+float3 Dummy0;
+META_CB_END
+
+Texture2D Image : register(t0);
+
+// Matches ImDrawVert layout (pos, uv, packed color unpacked by the input assembler)
+struct VertexInput
+{
+    float2 Position : POSITION0;
+    float2 TexCoord : TEXCOORD0;
+    float4 Color    : COLOR0;
+};
+
+struct VS2PS
+{
+    float4 Position : SV_Position;
+    float4 Color    : COLOR0;
+    float2 TexCoord : TEXCOORD0;
+};
+
+META_VS(true, FEATURE_LEVEL_ES2)
+META_PERMUTATION_1(BGRA_PACKED_COLOR=0)
+META_PERMUTATION_1(BGRA_PACKED_COLOR=1)
+META_VS_IN_ELEMENT(POSITION, 0, R32G32_FLOAT,   0, ALIGN, PER_VERTEX, 0, true)
+META_VS_IN_ELEMENT(TEXCOORD, 0, R32G32_FLOAT,   0, ALIGN, PER_VERTEX, 0, true)
+META_VS_IN_ELEMENT(COLOR,    0, R8G8B8A8_UNORM, 0, ALIGN, PER_VERTEX, 0, true)
+VS2PS VS(VertexInput input)
+{
+    VS2PS output;
+    output.Position = mul(float4(input.Position, 0, 1), ViewProjection);
+#if BGRA_PACKED_COLOR
+    // Color packed with IMGUI_USE_BGRA_PACKED_COLOR
+    output.Color = input.Color.bgra;
+#else
+    output.Color = input.Color;
+#endif
+    output.TexCoord = input.TexCoord;
+    return output;
+}
+
+META_PS(true, FEATURE_LEVEL_ES2)
+float4 PS(VS2PS input) : SV_Target
+{
+    return input.Color * Image.Sample(SamplerLinearClamp, input.TexCoord);
+}
+
+// Composites the interface drawn into the offscreen texture (premultiplied alpha)
+META_PS(true, FEATURE_LEVEL_ES2)
+float4 PS_Composite(Quad_VS2PS input) : SV_Target
+{
+    return Image.Sample(SamplerPointClamp, input.TexCoord);
+}
+
+// Single-channel texture (eg. font atlas) with coverage in red channel (or signed distance to the glyph outline if FontSDF is set)
+META_PS(true, FEATURE_LEVEL_ES2)
+float4 PS_Font(VS2PS input) : SV_Target
+{
+    float coverage = Image.Sample(SamplerLinearClamp, input.TexCoord).r;
+    if (FontSDF > 0)
+    {
+        // Antialias the outline (at 0.5) over a single screen pixel so text stays sharp at any scale
+        float width = max(fwidth(coverage), 0.0001f);
+        coverage = saturate((coverage - 0.5f) / width + 0.5f);
+    }
+    return input.Color * float4(1, 1, 1, coverage);
+}